@@ -5,10 +5,15 @@
 #include <limits>
 #include <optional>
 #include <algorithm>
+#include <cmath>
+#include <deque>
+#include <functional>
 #include <iostream>
+#include <unordered_map>
 
 #include "../../problems/Evaluator.h"
 #include "../../solutions/Solution.h"
+#include "PathRelinking.h"
 
 template <typename E>
 class AbstractGRASP {
@@ -26,6 +31,18 @@ class AbstractGRASP {
         std::vector<E> CL;
         std::vector<E> RCL;
 
+        // Reactive GRASP: alpha is drawn from reactiveAlphas and the probabilities are
+        // re-estimated every reactiveBlock iterations from the mean cost each alpha produced.
+        std::vector<double> reactiveAlphas;
+        std::vector<double> reactiveProbs;
+        int reactiveBlock{0};
+        double reactiveDelta{10.0};
+
+        // Post-LS stage: path relinking between each local optimum and an elite solution.
+        bool pathRelinking{false};
+        PRMode prMode{PRMode::Mixed};
+        ElitePool<E> elitePool;
+
         AbstractGRASP(Evaluator<E>& obj_function, double alpha_, int iterations_)
             : ObjFunction(obj_function),
             alpha(alpha_),
@@ -47,6 +64,10 @@ class AbstractGRASP {
 
         virtual Solution<E> localSearch() = 0;
 
+        // Whether localSearch() ends at a local optimum; descents that stop early
+        // (e.g. sampled ones) return false and bypass the local-optimum memo.
+        virtual bool localSearchIsExact() const { return true; }
+
         virtual Solution<E> constructiveHeuristic() {
             CL  = makeCL();
             RCL = makeRCL();
@@ -92,11 +113,111 @@ class AbstractGRASP {
             return *sol;
         }
 
+        void setReactive(const std::vector<double>& alphas, int block, double delta = 10.0) {
+            reactiveAlphas = alphas;
+            reactiveBlock = std::max(1, block);
+            reactiveDelta = delta;
+            reactiveProbs.assign(alphas.size(), alphas.empty() ? 0.0 : 1.0 / alphas.size());
+            reactiveCostSum.assign(alphas.size(), 0.0);
+            reactiveCount.assign(alphas.size(), 0);
+            reactiveIdx = -1;
+            reactiveIter = 0;
+            reactiveBest = std::numeric_limits<double>::infinity();
+        }
+
+        bool isReactive() const { return !reactiveAlphas.empty(); }
+
+        // Local-optimum memo: maps the sorted elements of a solution handed to
+        // localSearch() to the local optimum it reached. Low alphas rebuild the same
+        // starts often, and a hit replaces the descent with a copy. The optimum is also
+        // stored under its own signature (a descent from it stops at once), and so is
+        // every intermediate state a descent reports through descentStep(). At
+        // most capacity entries are kept, oldest evicted first; 0 disables the memo.
+        void enableLocalOptimumCache(std::size_t capacity) {
+            memoCapacity = capacity;
+            memo.clear();
+            memoOrder.clear();
+            memoLookups = 0;
+            memoHits = 0;
+        }
+
+        // Lookups are memoized local searches; hits are those skipped or cut short.
+        long localOptimumLookups() const { return memoLookups; }
+        long localOptimumHits() const { return memoHits; }
+        double localOptimumHitRate() const {
+            return memoLookups > 0 ? static_cast<double>(memoHits) / memoLookups : 0.0;
+        }
+
+        // Lower-bound filter: local search is assumed to scale a construction's cost by
+        // the mean ratio (local optimum / construction) of the full descents run so far.
+        // After warmup descents, constructions whose predicted optimum is above
+        // (1 + margin) * best get a descent truncated to truncatedMoves moves (0: none;
+        // only descents that report their moves through descentStep() are truncated).
+        void setLocalSearchFilter(double margin, int truncatedMoves = 0, int warmup = 10) {
+            filterOn = true;
+            filterMargin = margin;
+            filterTruncatedMoves = std::max(0, truncatedMoves);
+            filterWarmup = std::max(1, warmup);
+            filterRatioSum = 0.0;
+            filterRatioCount = 0;
+            filterPassed = 0;
+            filterSkipped = 0;
+        }
+
+        long localSearchesPassed() const { return filterPassed; }
+        long localSearchesSkipped() const { return filterSkipped; }
+
+        void enablePathRelinking(int poolSize, PRMode mode = PRMode::Mixed, int minDistance = 2) {
+            pathRelinking = true;
+            prMode = mode;
+            elitePool = ElitePool<E>(poolSize, minDistance);
+        }
+
+        // One GRASP iteration: construction followed by local search. Loops that drive
+        // the iterations themselves (e.g. with time limits) should call this instead of
+        // the two phases so that the reactive bookkeeping stays consistent.
+        Solution<E> iterate() {
+            if (isReactive()) selectReactiveAlpha();
+
+            constructiveHeuristic();
+            bool admitted = filterAdmits();
+            if (admitted)
+                filteredLocalSearch();
+            else
+                truncatedLocalSearch();
+
+            // filtered constructions did not get a full descent, so their cost would
+            // score their alpha against local optima; the reactive scores skip them
+            if (isReactive() && admitted) updateReactive(sol->cost);
+            if (pathRelinking && admitted) relinkWithElite();
+            return *sol;
+        }
+
+        // Relinks sol with an elite member, runs local search from the best solution on
+        // the path and keeps it if it beats sol. sol is then offered to the pool.
+        void relinkWithElite() {
+            int g = elitePool.empty() ? -1 : elitePool.pickGuide(*sol, rng);
+            if (g >= 0) {
+                Solution<E> guide = elitePool.members()[g];
+                PathRelinking<E> pr(ObjFunction);
+                Solution<E> cand = pr.relink(*sol, guide, prMode);
+
+                if (std::isfinite(cand.cost)) {
+                    Solution<E> local(*sol);
+                    sol = cand;
+                    CL = makeCL();
+                    localSearch();
+                    if (!(sol->cost < local.cost)) sol = local;
+                }
+            }
+            elitePool.tryAdd(*sol);
+        }
+
         Solution<E> solve() {
             bestSol = createEmptySol();
+            elitePool.clear();
             for (int i = 0; i < iterations; ++i) {
-                constructiveHeuristic();
-                localSearch();
+                iterate();
 
                 if (bestSol->cost > sol->cost) {
                     bestSol = Solution<E>(*sol);
@@ -115,4 +236,172 @@ class AbstractGRASP {
         }
 
         static void set_seed(unsigned seed) { rng.seed(seed); }
+
+    protected:
+        // Called by descents after each applied move; true means the descent should
+        // stop: either its move budget (truncated search) is used up, or the current
+        // state is memoized and sol now holds its local optimum.
+        bool descentStep() {
+            if (descentBudget > 0 && ++descentMoves >= descentBudget) return true;
+            if (!memoTracing) return false;
+            std::vector<E> sig = signature(*sol);
+            auto it = memo.find(sig);
+            if (it != memo.end()) {
+                sol = it->second;
+                memoShortcut = true;
+                return true;
+            }
+            memoPath.push_back(std::move(sig));
+            return false;
+        }
+
+    private:
+        struct SignatureHash {
+            std::size_t operator()(const std::vector<E>& sig) const {
+                std::size_t h = sig.size();
+                for (const E& e : sig)
+                    h ^= std::hash<E>{}(e) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+                return h;
+            }
+        };
+
+        std::size_t memoCapacity{0};
+        std::unordered_map<std::vector<E>, Solution<E>, SignatureHash> memo;
+        std::deque<std::vector<E>> memoOrder;
+        long memoLookups{0};
+        long memoHits{0};
+        bool memoTracing{false};
+        int descentBudget{0};
+        int descentMoves{0};
+
+        bool filterOn{false};
+        double filterMargin{0.0};
+        int filterTruncatedMoves{0};
+        int filterWarmup{10};
+        double filterRatioSum{0.0};
+        long filterRatioCount{0};
+        long filterPassed{0};
+        long filterSkipped{0};
+        bool memoShortcut{false};
+        std::vector<std::vector<E>> memoPath;
+
+        static std::vector<E> signature(const Solution<E>& s) {
+            std::vector<E> sig(s.begin(), s.end());
+            std::sort(sig.begin(), sig.end());
+            return sig;
+        }
+
+        void remember(std::vector<E> sig, const Solution<E>& local) {
+            if (memo.count(sig)) return;
+            if (memo.size() >= memoCapacity) {
+                memo.erase(memoOrder.front());
+                memoOrder.pop_front();
+            }
+            memo.emplace(sig, local);
+            memoOrder.push_back(std::move(sig));
+        }
+
+        void memoizedLocalSearch() {
+            if (memoCapacity == 0 || !localSearchIsExact()) {
+                localSearch();
+                return;
+            }
+
+            std::vector<E> start = signature(*sol);
+            ++memoLookups;
+            auto it = memo.find(start);
+            if (it != memo.end()) {
+                ++memoHits;
+                sol = it->second;
+                return;
+            }
+
+            memoPath.clear();
+            memoPath.push_back(std::move(start));
+            memoTracing = true;
+            memoShortcut = false;
+            localSearch();
+            memoTracing = false;
+            if (memoShortcut) ++memoHits;
+
+            memoPath.push_back(signature(*sol));
+            for (auto& sig : memoPath) remember(std::move(sig), *sol);
+            memoPath.clear();
+        }
+
+        bool filterAdmits() {
+            if (!filterOn) return true;
+            if (!std::isfinite(sol->cost)) sol->cost = ObjFunction.evaluate(*sol);
+
+            double best = bestSol.has_value() ? bestSol->cost
+                                               : std::numeric_limits<double>::infinity();
+            bool pass = true;
+            if (filterRatioCount >= filterWarmup && std::isfinite(best)) {
+                double predicted = sol->cost * (filterRatioSum / filterRatioCount);
+                pass = predicted <= (1.0 + filterMargin) * best;
+            }
+            if (pass)
+                ++filterPassed;
+            else
+                ++filterSkipped;
+            return pass;
+        }
+
+        void filteredLocalSearch() {
+            double built = sol->cost;
+            memoizedLocalSearch();
+            if (filterOn && std::isfinite(built) && built > 0.0 && std::isfinite(sol->cost)) {
+                filterRatioSum += sol->cost / built;
+                ++filterRatioCount;
+            }
+        }
+
+        void truncatedLocalSearch() {
+            if (filterTruncatedMoves == 0) return;
+            descentBudget = filterTruncatedMoves;
+            descentMoves = 0;
+            localSearch();
+            descentBudget = 0;
+        }
+
+        std::vector<double> reactiveCostSum;
+        std::vector<int> reactiveCount;
+        int reactiveIdx{-1};
+        int reactiveIter{0};
+        double reactiveBest{std::numeric_limits<double>::infinity()};
+
+        void selectReactiveAlpha() {
+            std::discrete_distribution<std::size_t> dist(reactiveProbs.begin(), reactiveProbs.end());
+            reactiveIdx = static_cast<int>(dist(rng));
+            alpha = reactiveAlphas[reactiveIdx];
+        }
+
+        void updateReactive(double iterCost) {
+            if (reactiveIdx < 0 || !std::isfinite(iterCost)) return;
+
+            reactiveCostSum[reactiveIdx] += iterCost;
+            reactiveCount[reactiveIdx] += 1;
+            reactiveBest = std::min(reactiveBest, iterCost);
+
+            if (++reactiveIter % reactiveBlock != 0) return;
+
+            // q_i = (best / mean_i)^delta; alphas not sampled yet keep the largest score
+            // so they still get a chance in the next block.
+            std::vector<double> q(reactiveAlphas.size(), -1.0);
+            double q_max = 0.0;
+            for (std::size_t i = 0; i < q.size(); ++i) {
+                if (reactiveCount[i] == 0) continue;
+                double mean = reactiveCostSum[i] / reactiveCount[i];
+                q[i] = (mean > 0.0) ? std::pow(reactiveBest / mean, reactiveDelta) : 1.0;
+                q_max = std::max(q_max, q[i]);
+            }
+            if (q_max <= 0.0) return;
+
+            double total = 0.0;
+            for (auto& qi : q) {
+                if (qi < 0.0) qi = q_max;
+                total += qi;
+            }
+            for (std::size_t i = 0; i < q.size(); ++i) reactiveProbs[i] = q[i] / total;
+        }
 };
@@ -0,0 +1,169 @@
+// PathRelinking.h
+#pragma once
+#include <vector>
+#include <random>
+#include <limits>
+#include <algorithm>
+#include <iterator>
+
+#include "../../problems/Evaluator.h"
+#include "../../solutions/Solution.h"
+
+enum class PRMode {
+    Forward,   // from the new local optimum towards the elite solution
+    Backward,  // from the elite solution towards the new local optimum
+    Mixed      // both ends walk towards each other, one step at a time
+};
+
+// Number of elements of a that are not in b (for equal-size solutions this is the
+// number of swaps needed to turn one into the other).
+template <typename E>
+int solutionDistance(const Solution<E>& a, const Solution<E>& b) {
+    std::vector<E> sa(a.begin(), a.end()), sb(b.begin(), b.end());
+    std::sort(sa.begin(), sa.end());
+    std::sort(sb.begin(), sb.end());
+    std::vector<E> diff;
+    std::set_difference(sa.begin(), sa.end(), sb.begin(), sb.end(), std::back_inserter(diff));
+    return static_cast<int>(diff.size());
+}
+
+// Bounded pool of good and mutually different local optima.
+template <typename E>
+class ElitePool {
+    public:
+        explicit ElitePool(int capacity = 10, int minDistance = 1)
+            : capacity_(std::max(1, capacity)), minDistance_(std::max(1, minDistance)) {}
+
+        const std::vector<Solution<E>>& members() const { return members_; }
+        bool empty() const { return members_.empty(); }
+        void clear() { members_.clear(); }
+
+        // A candidate enters if it is better than every member, or if it is at least
+        // minDistance away from all of them and (when full) better than the worst one.
+        // When full it replaces the most similar member among those it beats.
+        bool tryAdd(const Solution<E>& cand) {
+            int closest = std::numeric_limits<int>::max();
+            double best = std::numeric_limits<double>::infinity();
+            for (auto& m : members_) {
+                closest = std::min(closest, solutionDistance(cand, m));
+                best = std::min(best, m.cost);
+            }
+            if (closest == 0) return false;
+            if (cand.cost >= best && closest < minDistance_) return false;
+
+            if (static_cast<int>(members_.size()) < capacity_) {
+                members_.push_back(cand);
+                return true;
+            }
+
+            int victim = -1;
+            int victim_dist = std::numeric_limits<int>::max();
+            for (std::size_t i = 0; i < members_.size(); ++i) {
+                if (members_[i].cost <= cand.cost) continue;
+                int d = solutionDistance(cand, members_[i]);
+                if (d < victim_dist) {
+                    victim_dist = d;
+                    victim = static_cast<int>(i);
+                }
+            }
+            if (victim < 0) return false;
+            members_[victim] = cand;
+            return true;
+        }
+
+        // Elite member drawn with probability proportional to its distance from sol;
+        // members closer than 2 swaps are skipped since there is no path between them.
+        int pickGuide(const Solution<E>& sol, std::mt19937& rng) const {
+            std::vector<double> w(members_.size(), 0.0);
+            double total = 0.0;
+            for (std::size_t i = 0; i < members_.size(); ++i) {
+                int d = solutionDistance(sol, members_[i]);
+                w[i] = (d >= 2) ? static_cast<double>(d) : 0.0;
+                total += w[i];
+            }
+            if (total <= 0.0) return -1;
+            std::discrete_distribution<std::size_t> dist(w.begin(), w.end());
+            return static_cast<int>(dist(rng));
+        }
+
+    private:
+        int capacity_;
+        int minDistance_;
+        std::vector<Solution<E>> members_;
+};
+
+// Path relinking over the swap neighborhood: each step applies the best exchange
+// (in from the guide, out from the current solution) according to
+// Evaluator::evaluate_exchange_cost. Returns the best intermediate solution found
+// strictly inside the path (cost = +inf if the endpoints are adjacent).
+template <typename E>
+class PathRelinking {
+    public:
+        explicit PathRelinking(Evaluator<E>& obj) : ObjFunction(obj) {}
+
+        Solution<E> relink(const Solution<E>& a, const Solution<E>& b, PRMode mode) {
+            best_ = Solution<E>();
+            if (mode == PRMode::Forward) {
+                walk(a, b);
+            } else if (mode == PRMode::Backward) {
+                walk(b, a);
+            } else {
+                mixed(a, b);
+            }
+            return best_;
+        }
+
+    private:
+        Evaluator<E>& ObjFunction;
+        Solution<E> best_;
+
+        static std::vector<E> missing(const Solution<E>& from, const Solution<E>& to) {
+            std::vector<E> out;
+            for (auto& e : to)
+                if (std::find(from.begin(), from.end(), e) == from.end()) out.push_back(e);
+            return out;
+        }
+
+        // Applies the best swap moving cur one step towards guide. Returns false when
+        // cur already equals guide.
+        bool step(Solution<E>& cur, const Solution<E>& guide) {
+            std::vector<E> ins = missing(cur, guide);
+            std::vector<E> outs = missing(guide, cur);
+            if (ins.empty() || outs.empty()) return false;
+
+            double best_dc = std::numeric_limits<double>::infinity();
+            E best_in = ins[0], best_out = outs[0];
+            for (auto& in : ins) {
+                for (auto& out : outs) {
+                    double dc = ObjFunction.evaluate_exchange_cost(in, out, cur);
+                    if (dc < best_dc) {
+                        best_dc = dc;
+                        best_in = in;
+                        best_out = out;
+                    }
+                }
+            }
+
+            *std::find(cur.begin(), cur.end(), best_out) = best_in;
+            cur.cost = ObjFunction.evaluate(cur);
+
+            // the last step lands on the guide itself, which is not a new solution
+            if (ins.size() > 1 && cur.cost < best_.cost) best_ = Solution<E>(cur);
+            return true;
+        }
+
+        void walk(const Solution<E>& start, const Solution<E>& guide) {
+            Solution<E> cur(start);
+            while (step(cur, guide)) {}
+        }
+
+        void mixed(const Solution<E>& a, const Solution<E>& b) {
+            Solution<E> from_a(a), from_b(b);
+            bool turn_a = true;
+            while (solutionDistance(from_a, from_b) > 1) {
+                if (turn_a) step(from_a, from_b);
+                else step(from_b, from_a);
+                turn_a = !turn_a;
+            }
+        }
+};
@@ -0,0 +1,27 @@
+#include "Float32Distances.h"
+
+#include <algorithm>
+#include <cmath>
+
+Float32Distances::Float32Distances(const PointFeatures& features)
+    : n_(features.n()), d_(static_cast<size_t>(n_) * n_, 0.0f)
+{
+    vector<double> keys(n_);
+    with_metric(features.metric(),
+                [&](auto policy)
+                {
+                    using M = decltype(policy);
+                    for (int i = 0; i < n_; ++i)
+                    {
+                        features.keys_from<M>(i, keys.data(), i + 1);
+                        for (int j = i + 1; j < n_; ++j)
+                        {
+                            double exact = M::finish(keys[j]);
+                            float d = static_cast<float>(exact);
+                            max_error_ = max(max_error_, abs(static_cast<double>(d) - exact));
+                            d_[static_cast<size_t>(i) * n_ + j] = d;
+                            d_[static_cast<size_t>(j) * n_ + i] = d;
+                        }
+                    }
+                });
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+#include "PointFeatures.h"
+
+using namespace std;
+
+// n x n distance matrix (in the features' metric) stored in float32 (row-major, one
+// block): half the memory and bandwidth of vector<vector<double>>. Distances are
+// computed in double from the features and rounded once, so every entry is within
+// max_error() (at most 2^-24 of the largest distance) of the exact value; the
+// evaluator uses that bound to re-verify screened moves and reported costs in double.
+class Float32Distances
+{
+   public:
+    explicit Float32Distances(const PointFeatures& features);
+
+    int n() const { return n_; }
+
+    const float* row(int i) const { return &d_[static_cast<size_t>(i) * n_]; }
+
+    double max_error() const { return max_error_; }
+
+   private:
+    int n_{0};
+    vector<float> d_;
+    double max_error_{0.0};
+};
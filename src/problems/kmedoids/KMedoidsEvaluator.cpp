@@ -1,50 +1,416 @@
 #include "KMedoidsEvaluator.h"
 
+// Distances from one point, read from its row of D.
+struct KMedoidsEvaluator::DenseRow
+{
+    const double* row;
+
+    double at(int i) const { return row[i]; }
+
+    // True, with d set, when the distance to i is below bound.
+    bool closer(int i, double bound, double& d) const
+    {
+        d = row[i];
+        return d < bound;
+    }
+};
+
+// Distances from one point, read from its float32 row; compared and accumulated in
+// double.
+struct KMedoidsEvaluator::FloatRow
+{
+    const float* row;
+
+    double at(int i) const { return row[i]; }
+
+    bool closer(int i, double bound, double& d) const
+    {
+        d = row[i];
+        return d < bound;
+    }
+};
+
+// Distances from one point, decoded from its 16-bit row.
+struct KMedoidsEvaluator::QuantRow
+{
+    const uint16_t* codes;
+    double scale;
+
+    double at(int i) const { return codes[i] * scale; }
+
+    bool closer(int i, double bound, double& d) const
+    {
+        d = codes[i] * scale;
+        return d < bound;
+    }
+};
+
+// Policy keys from one point (squared distances for Euclidean), computed from the
+// features in one vectorizable pass. The key is compared against the bound's key
+// first, so finish (the square root) is only paid by points that pass, which most
+// points fail.
+template <class M>
+struct KMedoidsEvaluator::FeatureRow
+{
+    const double* key;
+
+    double at(int i) const { return M::finish(key[i]); }
+
+    bool closer(int i, double bound, double& d) const
+    {
+        double s = key[i];
+        if (!(s < M::key_of(bound))) return false;
+        d = M::finish(s);
+        return d < bound;
+    }
+};
+
+template <class M>
+KMedoidsEvaluator::FeatureRow<M> KMedoidsEvaluator::feature_row(int p) const
+{
+    features_->keys_from<M>(p, key_row_.data());
+    return FeatureRow<M>{key_row_.data()};
+}
+
+KMedoidsEvaluator::QuantRow KMedoidsEvaluator::quant_row(int p) const
+{
+    return QuantRow{quant_->codes(p), quant_->scale(p)};
+}
+
 KMedoidsEvaluator::KMedoidsEvaluator(const vector<vector<double>>& D, int k)
-    : D_(D), n_(static_cast<int>(D.size())), k_(k)
+    : D_(D), n_(static_cast<int>(D.size())), k_(k), w_(n_, 1.0), total_w_(n_)
+{
+}
+
+void KMedoidsEvaluator::use_features(shared_ptr<const PointFeatures> features)
+{
+    features_ = move(features);
+    n_ = features_->n();
+    vector<vector<double>>().swap(D_);
+    vector<double>().swap(panel_);
+    panel_stride_ = 0;
+    key_row_.assign(n_, 0.0);
+    x_buf_.assign(features_->d(), 0.0);
+    w_.assign(n_, 1.0);
+    total_w_ = n_;
+    state_valid_ = false;
+    clusters_valid_ = false;
+}
+
+void KMedoidsEvaluator::use_float32(shared_ptr<const Float32Distances> dist32,
+                                    shared_ptr<const PointFeatures> exact)
+{
+    dist32_ = move(dist32);
+    exact_ = move(exact);
+    n_ = dist32_->n();
+    // rounding leaves every float entry within e of the exact distance, so the same
+    // 3e margin as in use_quantized covers both the screened terms and the points
+    // skipped by triangle pruning on rounded distances
+    approx_error_ = dist32_->max_error();
+    screen_tol_ = 3.0 * approx_error_;
+    vector<vector<double>>().swap(D_);
+    vector<double>().swap(panel_);
+    panel_stride_ = 0;
+    w_.assign(n_, 1.0);
+    total_w_ = n_;
+    state_valid_ = false;
+    clusters_valid_ = false;
+}
+
+void KMedoidsEvaluator::use_quantized(shared_ptr<const Quantized16Distances> quant,
+                                      shared_ptr<const PointFeatures> exact)
 {
+    quant_ = move(quant);
+    exact_ = move(exact);
+    n_ = quant_->n();
+    // per point, each of d(i, in), d(i, nearest), d(i, second) is off by at most e, and
+    // a point skipped by the approximate triangle bound can hide at most 3e of gain
+    approx_error_ = quant_->max_error();
+    screen_tol_ = 3.0 * approx_error_;
+    vector<vector<double>>().swap(D_);
+    vector<double>().swap(panel_);
+    panel_stride_ = 0;
+    w_.assign(n_, 1.0);
+    total_w_ = n_;
+    state_valid_ = false;
+    clusters_valid_ = false;
 }
 
-double KMedoidsEvaluator::avg_from_medoids(const vector<int>& medoids) const
+void KMedoidsEvaluator::set_weights(const vector<double>& w)
 {
-    if (medoids.empty())
+    if (w.empty())
     {
-        return numeric_limits<double>::infinity();
+        w_.assign(n_, 1.0);
+        total_w_ = n_;
+        return;
     }
-    double total = 0.0;
+    w_ = w;
+    total_w_ = accumulate(w_.begin(), w_.end(), 0.0);
+}
+
+void KMedoidsEvaluator::rebuild_state(const Solution<int>& sol) const
+{
+    const double inf = numeric_limits<double>::infinity();
+
+    medoids_.clear();
+    is_medoid_.assign(n_, 0);
+    near1_.assign(n_, -1);
+    near2_.assign(n_, -1);
+    dist1_.assign(n_, inf);
+    dist2_.assign(n_, inf);
+
+    for (int m : sol) add_medoid(m);
+    state_valid_ = true;
+    clusters_valid_ = false;
+}
+
+void KMedoidsEvaluator::add_medoid(int p) const
+{
+    if (is_medoid_[p]) return;
+    is_medoid_[p] = 1;
+    medoids_.push_back(p);
+    clusters_valid_ = false;
+
+    int slot = static_cast<int>(medoids_.size()) - 1;
+    if (slot >= panel_stride_) grow_panel(max({2 * panel_stride_, slot + 1, k_}));
+
+    if (dist32_)
+        add_medoid_from(p, slot, FloatRow{dist32_->row(p)});
+    else if (quant_)
+        add_medoid_from(p, slot, quant_row(p));
+    else if (features_)
+        with_metric(features_->metric(), [&](auto policy)
+                    { add_medoid_from(p, slot, feature_row<decltype(policy)>(p)); });
+    else
+        add_medoid_from(p, slot, DenseRow{D_[p].data()});
+}
+
+// Widens the medoid panel, keeping the columns of the current medoids.
+void KMedoidsEvaluator::grow_panel(int stride) const
+{
+    vector<double> wider(static_cast<size_t>(n_) * stride);
     for (int i = 0; i < n_; ++i)
+        for (int s = 0; s < panel_stride_; ++s)
+            wider[static_cast<size_t>(i) * stride + s] = panel_[static_cast<size_t>(i) * panel_stride_ + s];
+    panel_.swap(wider);
+    panel_stride_ = stride;
+}
+
+template <class Row>
+void KMedoidsEvaluator::add_medoid_from(int p, int slot, const Row& row) const
+{
+    double* col = panel_.data() + slot;
+    for (int i = 0; i < n_; ++i, col += panel_stride_)
     {
-        double best = numeric_limits<double>::infinity();
-        for (int m : medoids)
+        double d = row.at(i);
+        *col = d;
+        if (!(d < dist2_[i])) continue;
+        if (d < dist1_[i])
+        {
+            near2_[i] = near1_[i];
+            dist2_[i] = dist1_[i];
+            near1_[i] = p;
+            dist1_[i] = d;
+        }
+        else
         {
-            best = min(best, D_[i][m]);
+            near2_[i] = p;
+            dist2_[i] = d;
         }
-        total += best;
     }
-    return total / static_cast<double>(n_);
 }
 
-double KMedoidsEvaluator::base_avg(const Solution<int>& sol) const
+void KMedoidsEvaluator::remove_medoid(int q) const
 {
-    if (sol.empty())
+    if (!is_medoid_[q]) return;
+    is_medoid_[q] = 0;
+    clusters_valid_ = false;
+
+    // the last medoid takes over q's slot, in medoids_ and in the panel
+    int slot = static_cast<int>(find(medoids_.begin(), medoids_.end(), q) - medoids_.begin());
+    int last = static_cast<int>(medoids_.size()) - 1;
+    medoids_[slot] = medoids_[last];
+    medoids_.pop_back();
+
+    const double inf = numeric_limits<double>::infinity();
+    for (int i = 0; i < n_; ++i)
     {
-        return numeric_limits<double>::infinity();
+        double* pi = &panel_[static_cast<size_t>(i) * panel_stride_];
+        pi[slot] = pi[last];
+
+        if (near1_[i] == q)
+        {
+            int old2 = near2_[i];
+            near1_[i] = old2;
+            dist1_[i] = dist2_[i];
+
+            double d = inf;
+            near2_[i] = (old2 < 0) ? -1 : next_medoid_after(i, dist1_[i], old2, d);
+            dist2_[i] = d;
+        }
+        else if (near2_[i] == q)
+        {
+            double d = inf;
+            near2_[i] = next_medoid_after(i, dist2_[i], near1_[i], d);
+            dist2_[i] = d;
+        }
+    }
+}
+
+// First medoid other than `exclude` at distance >= from_dist from i (distance in d),
+// found by walking i's sorted list from the first entry at that distance. The lists
+// leave out i itself, so a medoid i (distance 0, nearer than any list entry) is
+// answered before the walk. Falls back to a scan of i's panel row when there are no
+// rank lists or the truncated list runs out.
+int KMedoidsEvaluator::next_medoid_after(int i, double from_dist, int exclude, double& d) const
+{
+    if (is_medoid_[i] && i != exclude)
+    {
+        d = 0.0;
+        return i;
+    }
+    if (!ranks_ || D_.empty()) return scan_nearest_excluding(i, exclude, d);
+
+    const auto& list = ranks_->neighbors(i);
+    const auto& row = D_[i];
+    auto it = lower_bound(list.begin(), list.end(), from_dist,
+                          [&row](int a, double v) { return row[a] < v; });
+
+    for (; it != list.end(); ++it)
+    {
+        if (is_medoid_[*it] && *it != exclude)
+        {
+            d = row[*it];
+            return *it;
+        }
+    }
+    return scan_nearest_excluding(i, exclude, d);
+}
+
+// Min-reduction over the k contiguous panel entries of point i (unrolled for small k,
+// see MedoidScan.h).
+int KMedoidsEvaluator::scan_nearest_excluding(int i, int exclude, double& best_d) const
+{
+    const double* pi = &panel_[static_cast<size_t>(i) * panel_stride_];
+    const int* ms = medoids_.data();
+    const double inf = numeric_limits<double>::infinity();
+
+    int s = nearest_slot(static_cast<int>(medoids_.size()),
+                         [pi, ms, exclude, inf](int t) { return ms[t] != exclude ? pi[t] : inf; },
+                         best_d);
+    return s < 0 ? -1 : ms[s];
+}
+
+void KMedoidsEvaluator::build_clusters() const
+{
+    const int k = static_cast<int>(medoids_.size());
+    vector<int> slot_of(n_, -1);
+    for (int s = 0; s < k; ++s) slot_of[medoids_[s]] = s;
+
+    cluster_start_.assign(k + 1, 0);
+    for (int i = 0; i < n_; ++i) ++cluster_start_[slot_of[near1_[i]] + 1];
+    for (int s = 0; s < k; ++s) cluster_start_[s + 1] += cluster_start_[s];
+
+    cluster_points_.resize(n_);
+    vector<int> fill_pos(cluster_start_.begin(), cluster_start_.end() - 1);
+    for (int i = 0; i < n_; ++i) cluster_points_[fill_pos[slot_of[near1_[i]]]++] = i;
+
+    cluster_dist_.resize(n_);
+    for (int s = 0; s < k; ++s)
+    {
+        auto first = cluster_points_.begin() + cluster_start_[s];
+        auto last = cluster_points_.begin() + cluster_start_[s + 1];
+        sort(first, last, [this](int a, int b) { return dist1_[a] < dist1_[b]; });
+        for (int r = cluster_start_[s]; r < cluster_start_[s + 1]; ++r)
+            cluster_dist_[r] = dist1_[cluster_points_[r]];
+    }
+
+    if (features_)
+    {
+        const int d = features_->d();
+        cluster_cols_.resize(static_cast<size_t>(d) * n_);
+        for (int j = 0; j < d; ++j)
+        {
+            const double* c = features_->column(j);
+            double* out = &cluster_cols_[static_cast<size_t>(j) * n_];
+            for (int r = 0; r < n_; ++r) out[r] = c[cluster_points_[r]];
+        }
+    }
+    clusters_valid_ = true;
+}
+
+// Policy keys from x to the points of ranks [b, e) of cluster_points_, into
+// key_row_[b, e). Unit-stride over the cluster-ordered coordinates.
+template <class M>
+void KMedoidsEvaluator::cluster_keys(const double* x, int b, int e) const
+{
+    const int d = features_->d();
+    double* key = key_row_.data();
+    fill(key + b, key + e, 0.0);
+    for (int j = 0; j < d; ++j)
+    {
+        const double* c = &cluster_cols_[static_cast<size_t>(j) * n_];
+        const double xj = x[j];
+        for (int r = b; r < e; ++r) key[r] = M::combine(key[r], M::term(c[r], xj));
     }
+}
+
+// Brings the cache to sol's medoid set: nothing to do when the sets match, a few
+// incremental removals/insertions when they differ slightly, a rebuild otherwise.
+void KMedoidsEvaluator::sync_state(const Solution<int>& sol) const
+{
+    if (!state_valid_)
+    {
+        rebuild_state(sol);
+        return;
+    }
+
+    vector<int> added;
+    for (int m : sol)
+        if (!is_medoid_[m]) added.push_back(m);
+
+    if (added.empty() && sol.size() == medoids_.size()) return;
+
+    vector<int> removed;
+    for (int m : medoids_)
+        if (!contains(sol, m)) removed.push_back(m);
 
-    if (isfinite(sol.cost))
+    if (added.size() + removed.size() > 4 || removed.size() >= medoids_.size())
     {
-        return sol.cost;
+        rebuild_state(sol);
+        return;
     }
-    vector<int> meds(sol.begin(), sol.end());
 
-    return avg_from_medoids(meds);
+    for (int q : removed) remove_medoid(q);
+    for (int p : added) add_medoid(p);
 }
 
 double KMedoidsEvaluator::evaluate(const Solution<int>& sol) const
 {
-    vector<int> meds(sol.begin(), sol.end());
+    if (sol.empty())
+    {
+        return numeric_limits<double>::infinity();
+    }
+    sync_state(sol);
 
-    return avg_from_medoids(meds);
+    double total = 0.0;
+    if (exact_)
+    {
+        // reported costs are recomputed in double; where the two nearest medoids are
+        // within 2e, the cached nearest may not be the exact one
+        for (int i = 0; i < n_; ++i)
+        {
+            double d1 = (dist2_[i] - dist1_[i] < 2.0 * approx_error_)
+                            ? exact_nearest(i, -1)
+                            : exact_->distance(i, near1_[i]);
+            total += w_[i] * d1;
+        }
+    }
+    else
+    {
+        for (int i = 0; i < n_; ++i) total += w_[i] * dist1_[i];
+    }
+    return total / total_w_;
 }
 
 double KMedoidsEvaluator::evaluate_insertion_cost(const int& elem, const Solution<int>& sol) const
@@ -53,13 +419,136 @@ double KMedoidsEvaluator::evaluate_insertion_cost(const int& elem, const Solutio
     {
         return numeric_limits<double>::infinity();
     }
-    vector<int> meds(sol.begin(), sol.end());
-    meds.push_back(elem);
 
-    double new_avg = avg_from_medoids(meds);
-    double base = base_avg(sol);
+    if (!sol.empty()) sync_state(sol);
+    return insertion_delta_of(elem, sol.empty());
+}
 
-    return isinf(base) ? new_avg : (new_avg - base);
+// Insertion delta of elem under the synced cache, from the active distance backend.
+double KMedoidsEvaluator::insertion_delta_of(int elem, bool empty) const
+{
+    if (dist32_) return insertion_delta(FloatRow{dist32_->row(elem)}, empty);
+    if (quant_) return insertion_delta(quant_row(elem), empty);
+    if (features_)
+        return with_metric(features_->metric(), [&](auto policy)
+                           { return insertion_delta(feature_row<decltype(policy)>(elem), empty); });
+    return insertion_delta(DenseRow{D_[elem].data()}, empty);
+}
+
+// Candidates are processed in blocks that share one pass over the cached nearest
+// distances and weights (loaded once per point for the whole block instead of once
+// per candidate). Feature mode computes each candidate's keys separately. With a
+// thread pool the cache is synced here, then chunks of candidates (whole blocks, so
+// the sums are those of the sequential pass) are evaluated in parallel.
+void KMedoidsEvaluator::evaluate_insertion_costs(const int* cands, int count,
+                                                 const Solution<int>& sol, double* out) const
+{
+    if (!sol.empty()) sync_state(sol);
+    const bool empty = sol.empty();
+
+    constexpr int B = 8;
+    if (!pool_ || pool_->size() == 1 || count < 2 * pool_min_chunk_)
+    {
+        insertion_costs_range(cands, count, empty, out, key_row_.data());
+        return;
+    }
+
+    int chunk = max(pool_min_chunk_, (count + 4 * pool_->size() - 1) / (4 * pool_->size()));
+    chunk = (chunk + B - 1) / B * B;
+    pool_->parallel_for(count, chunk,
+                        [&](int b, int e)
+                        {
+                            vector<double> keys(features_ ? n_ : 0);
+                            insertion_costs_range(cands + b, e - b, empty, out + b, keys.data());
+                        });
+}
+
+// Insertion deltas of cands[0, count) under the synced cache; keys is scratch for n
+// feature-mode distances. Reads shared state only, so disjoint ranges can run
+// concurrently.
+void KMedoidsEvaluator::insertion_costs_range(const int* cands, int count, bool empty,
+                                              double* out, double* keys) const
+{
+    if (features_)
+    {
+        with_metric(features_->metric(), [&](auto policy)
+                    {
+                        using M = decltype(policy);
+                        for (int j = 0; j < count; ++j)
+                        {
+                            features_->keys_from<M>(cands[j], keys);
+                            out[j] = insertion_delta(FeatureRow<M>{keys}, empty);
+                        }
+                    });
+        return;
+    }
+    if (empty)
+    {
+        for (int j = 0; j < count; ++j) out[j] = insertion_delta_of(cands[j], true);
+        return;
+    }
+
+    constexpr int B = 8;
+    for (int j0 = 0; j0 < count; j0 += B)
+    {
+        int m = min(B, count - j0);
+        if (dist32_)
+        {
+            FloatRow rows[B];
+            for (int b = 0; b < m; ++b) rows[b] = FloatRow{dist32_->row(cands[j0 + b])};
+            insertion_deltas(rows, m, out + j0);
+        }
+        else if (quant_)
+        {
+            QuantRow rows[B];
+            for (int b = 0; b < m; ++b) rows[b] = quant_row(cands[j0 + b]);
+            insertion_deltas(rows, m, out + j0);
+        }
+        else
+        {
+            DenseRow rows[B];
+            for (int b = 0; b < m; ++b) rows[b] = DenseRow{D_[cands[j0 + b]].data()};
+            insertion_deltas(rows, m, out + j0);
+        }
+    }
+}
+
+// Same sums as insertion_delta for each row, min(d - d1, 0) being the branch-free
+// form of its "closer" test.
+template <class Row>
+void KMedoidsEvaluator::insertion_deltas(const Row* rows, int m, double* out) const
+{
+    if (m < 8)
+    {
+        for (int b = 0; b < m; ++b) out[b] = insertion_delta(rows[b], false);
+        return;
+    }
+    double acc[8] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+    for (int i = 0; i < n_; ++i)
+    {
+        const double d1 = dist1_[i], wi = w_[i];
+        for (int b = 0; b < 8; ++b) acc[b] += wi * min(rows[b].at(i) - d1, 0.0);
+    }
+    for (int b = 0; b < 8; ++b) out[b] = acc[b] / total_w_;
+}
+
+// For an empty solution this is the cost of the single medoid itself.
+template <class Row>
+double KMedoidsEvaluator::insertion_delta(const Row& row, bool empty) const
+{
+    if (empty)
+    {
+        double total = 0.0;
+        for (int i = 0; i < n_; ++i) total += w_[i] * row.at(i);
+        return total / total_w_;
+    }
+
+    double delta = 0.0, d;
+    for (int i = 0; i < n_; ++i)
+    {
+        if (row.closer(i, dist1_[i], d)) delta += w_[i] * (d - dist1_[i]);
+    }
+    return delta / total_w_;
 }
 
 double KMedoidsEvaluator::evaluate_removal_cost(const int& elem, const Solution<int>& sol) const
@@ -68,17 +557,14 @@ double KMedoidsEvaluator::evaluate_removal_cost(const int& elem, const Solution<
     {
         return numeric_limits<double>::infinity();
     }
-    vector<int> meds;
-    meds.reserve(sol.size() - 1);
-    for (int v : sol)
+    sync_state(sol);
+
+    double delta = 0.0;
+    for (int i = 0; i < n_; ++i)
     {
-        if (v != elem) meds.push_back(v);
+        if (near1_[i] == elem) delta += w_[i] * (dist2_[i] - dist1_[i]);
     }
-
-    double new_avg = avg_from_medoids(meds);
-    double base = base_avg(sol);
-
-    return new_avg - base;
+    return delta / total_w_;
 }
 
 double KMedoidsEvaluator::evaluate_exchange_cost(const int& elem_in, const int& elem_out,
@@ -88,12 +574,337 @@ double KMedoidsEvaluator::evaluate_exchange_cost(const int& elem_in, const int&
     {
         return numeric_limits<double>::infinity();
     }
-    vector<int> meds(sol.begin(), sol.end());
-    auto it = find(meds.begin(), meds.end(), elem_out);
-    *it = elem_in;
+    sync_state(sol);
+
+    if (exact_)
+    {
+        // only moves that may be improving can be accepted, so only those are re-verified
+        double screened = dist32_ ? exchange_delta(FloatRow{dist32_->row(elem_in)}, elem_out)
+                                  : exchange_delta(quant_row(elem_in), elem_out);
+        return screened < screen_tol_ ? exact_exchange_delta(elem_in, elem_out) : screened;
+    }
+    if (features_)
+    {
+        return with_metric(features_->metric(),
+                           [&](auto policy)
+                           {
+                               using M = decltype(policy);
+                               return triangle_pruning_
+                                          ? exchange_delta_clustered<M>(elem_in, elem_out)
+                                          : exchange_delta(feature_row<M>(elem_in), elem_out);
+                           });
+    }
+    return exchange_delta(DenseRow{D_[elem_in].data()}, elem_out);
+}
+
+int KMedoidsEvaluator::best_exchange(int elem_in, const Solution<int>& sol,
+                                     double& best_delta) const
+{
+    best_delta = numeric_limits<double>::infinity();
+    if (sol.empty() || contains(sol, elem_in)) return -1;
+
+    double shared = exchange_losses_of(elem_in, sol);
+    double loss;
+    int s = nearest_slot(static_cast<int>(medoids_.size()),
+                         [&](int t) { return removal_loss_[t]; }, loss);
+    best_delta = (shared + loss) / total_w_;
+    if (exact_ && best_delta < screen_tol_)
+        best_delta = exact_exchange_delta(elem_in, medoids_[s]);
+    return medoids_[s];
+}
+
+void KMedoidsEvaluator::exchange_losses(int elem_in, const Solution<int>& sol, double& shared,
+                                        double* loss) const
+{
+    shared = exchange_losses_of(elem_in, sol) / total_w_;
+    for (size_t j = 0; j < sol.size(); ++j) loss[j] = removal_loss_[slot_of_[sol[j]]] / total_w_;
+}
+
+// Syncs to sol, fills removal_loss_ (slot order of medoids_, unnormalized) and
+// returns the shared term.
+double KMedoidsEvaluator::exchange_losses_of(int elem_in, const Solution<int>& sol) const
+{
+    sync_state(sol);
+    if (exact_)
+    {
+        return dist32_ ? exchange_losses_from(FloatRow{dist32_->row(elem_in)})
+                       : exchange_losses_from(quant_row(elem_in));
+    }
+    if (features_)
+    {
+        return with_metric(features_->metric(),
+                           [&](auto policy)
+                           {
+                               using M = decltype(policy);
+                               return exchange_losses_from(feature_row<M>(elem_in));
+                           });
+    }
+    return exchange_losses_from(DenseRow{D_[elem_in].data()});
+}
+
+// A point closer to `in` than to its nearest medoid moves to `in` whichever medoid
+// leaves (shared term); any other point only changes when its nearest medoid leaves,
+// and then goes to the closer of `in` and its second nearest.
+template <class Row>
+double KMedoidsEvaluator::exchange_losses_from(const Row& row) const
+{
+    const int k = static_cast<int>(medoids_.size());
+    if (static_cast<int>(slot_of_.size()) != n_) slot_of_.assign(n_, -1);
+    for (int s = 0; s < k; ++s) slot_of_[medoids_[s]] = s;
+    removal_loss_.assign(k, 0.0);
 
-    double new_avg = avg_from_medoids(meds);
-    double base = base_avg(sol);
+    double shared = 0.0, d;
+    for (int i = 0; i < n_; ++i)
+    {
+        if (row.closer(i, dist1_[i], d))
+        {
+            shared += w_[i] * (d - dist1_[i]);
+            continue;
+        }
+        double keep = row.closer(i, dist2_[i], d) ? d : dist2_[i];
+        removal_loss_[slot_of_[near1_[i]]] += w_[i] * (keep - dist1_[i]);
+    }
+    scanned_points_ += n_;
+    return shared;
+}
+
+KMedoidsEvaluator::NearestState KMedoidsEvaluator::nearest_state(const Solution<int>& sol) const
+{
+    sync_state(sol);
+    return NearestState{near1_.data(), dist1_.data(), dist2_.data(), w_.data(), total_w_};
+}
+
+double KMedoidsEvaluator::distance(int a, int b) const
+{
+    if (dist32_) return dist32_->row(a)[b];
+    if (quant_) return quant_row(a).at(b);
+    if (features_) return features_->distance(a, b);
+    return D_[a][b];
+}
+
+void KMedoidsEvaluator::draw_sample(const Solution<int>& sol, int batch, mt19937& rng) const
+{
+    sync_state(sol);
+    const int k = static_cast<int>(medoids_.size());
+    if (static_cast<int>(slot_of_.size()) != n_) slot_of_.assign(n_, -1);
+    for (int s = 0; s < k; ++s) slot_of_[medoids_[s]] = s;
 
-    return new_avg - base;
+    // points grouped by cluster (counting sort on the slot of the nearest medoid)
+    vector<int> start(k + 1, 0);
+    for (int i = 0; i < n_; ++i) ++start[slot_of_[near1_[i]] + 1];
+    for (int s = 0; s < k; ++s) start[s + 1] += start[s];
+    vector<int> grouped(n_);
+    vector<int> fill_pos(start.begin(), start.end() - 1);
+    for (int i = 0; i < n_; ++i) grouped[fill_pos[slot_of_[near1_[i]]]++] = i;
+
+    sample_points_.clear();
+    sample_start_.assign(1, 0);
+    sample_medoid_.clear();
+    stratum_size_.clear();
+    for (int s = 0; s < k; ++s)
+    {
+        const int size = start[s + 1] - start[s];
+        if (size == 0) continue;
+        int take = static_cast<int>(llround(static_cast<double>(batch) * size / n_));
+        take = min(size, max(take, 2));
+
+        // partial Fisher-Yates over the cluster
+        int* first = grouped.data() + start[s];
+        for (int r = 0; r < take; ++r)
+        {
+            uniform_int_distribution<int> pick(r, size - 1);
+            swap(first[r], first[pick(rng)]);
+            sample_points_.push_back(first[r]);
+        }
+        sample_start_.push_back(static_cast<int>(sample_points_.size()));
+        sample_medoid_.push_back(medoids_[s]);
+        stratum_size_.push_back(size);
+    }
+}
+
+double KMedoidsEvaluator::estimate_exchange_cost(int elem_in, int elem_out,
+                                                 double& std_err) const
+{
+    if (dist32_)
+    {
+        const float* row = dist32_->row(elem_in);
+        return sampled_exchange_delta([&](int i) { return static_cast<double>(row[i]); },
+                                      elem_out, std_err);
+    }
+    if (quant_)
+    {
+        QuantRow row = quant_row(elem_in);
+        return sampled_exchange_delta([&](int i) { return row.at(i); }, elem_out, std_err);
+    }
+    if (features_)
+    {
+        return sampled_exchange_delta([&](int i) { return features_->distance(elem_in, i); },
+                                      elem_out, std_err);
+    }
+    const double* row = D_[elem_in].data();
+    return sampled_exchange_delta([&](int i) { return row[i]; }, elem_out, std_err);
+}
+
+template <class Dist>
+double KMedoidsEvaluator::sampled_exchange_delta(const Dist& dist_in, int elem_out,
+                                                 double& std_err) const
+{
+    double total = 0.0, var = 0.0;
+    for (size_t h = 0; h + 1 < sample_start_.size(); ++h)
+    {
+        const int b = sample_start_[h], e = sample_start_[h + 1];
+        const bool removed = (sample_medoid_[h] == elem_out);
+        double sum = 0.0, sq = 0.0;
+        for (int r = b; r < e; ++r)
+        {
+            int i = sample_points_[r];
+            double keep = removed ? dist2_[i] : dist1_[i];
+            keep = min(keep, dist_in(i));
+            double t = w_[i] * (keep - dist1_[i]);
+            sum += t;
+            sq += t * t;
+        }
+
+        const double cnt = e - b, size = stratum_size_[h];
+        const double mean = sum / cnt;
+        total += size * mean;
+        if (cnt > 1 && cnt < size)
+        {
+            double s2 = max(0.0, (sq - cnt * mean * mean) / (cnt - 1));
+            var += size * size * s2 / cnt * (1.0 - cnt / size);
+        }
+    }
+    scanned_points_ += static_cast<long>(sample_points_.size());
+    std_err = sqrt(var) / total_w_;
+    return total / total_w_;
+}
+
+template <class Row>
+double KMedoidsEvaluator::exchange_delta(const Row& row, int elem_out) const
+{
+    double delta = 0.0, d;
+
+    if (!triangle_pruning_)
+    {
+        for (int i = 0; i < n_; ++i)
+        {
+            double keep = (near1_[i] == elem_out) ? dist2_[i] : dist1_[i];
+            if (row.closer(i, keep, d)) keep = d;
+            delta += w_[i] * (keep - dist1_[i]);
+        }
+        scanned_points_ += n_;
+        return delta / total_w_;
+    }
+
+    if (!clusters_valid_) build_clusters();
+
+    for (size_t s = 0; s < medoids_.size(); ++s)
+    {
+        int m = medoids_[s];
+        int b = cluster_start_[s], e = cluster_start_[s + 1];
+
+        if (m == elem_out)
+        {
+            for (int r = b; r < e; ++r)
+            {
+                int i = cluster_points_[r];
+                double keep = row.closer(i, dist2_[i], d) ? d : dist2_[i];
+                delta += w_[i] * (keep - cluster_dist_[r]);
+            }
+            scanned_points_ += e - b;
+            continue;
+        }
+
+        // d(i, in) >= d(in, m) - d(i, m) >= d(i, m) whenever d(i, m) <= d(in, m) / 2
+        double half = 0.5 * row.at(m);
+        int first = static_cast<int>(
+            upper_bound(cluster_dist_.begin() + b, cluster_dist_.begin() + e, half) -
+            cluster_dist_.begin());
+        pruned_points_ += first - b;
+        scanned_points_ += e - first;
+
+        for (int r = first; r < e; ++r)
+        {
+            if (row.closer(cluster_points_[r], cluster_dist_[r], d))
+                delta += w_[cluster_points_[r]] * (d - cluster_dist_[r]);
+        }
+    }
+    return delta / total_w_;
+}
+
+// Feature-space version of the pruned loop in exchange_delta: only the ranks that
+// survive the bound get a distance, computed from the cluster-ordered coordinates.
+template <class M>
+double KMedoidsEvaluator::exchange_delta_clustered(int elem_in, int elem_out) const
+{
+    if (!clusters_valid_) build_clusters();
+
+    const int d = features_->d();
+    double* x = x_buf_.data();
+    for (int j = 0; j < d; ++j) x[j] = features_->column(j)[elem_in];
+
+    const double* key = key_row_.data();
+    double delta = 0.0;
+    for (size_t s = 0; s < medoids_.size(); ++s)
+    {
+        int m = medoids_[s];
+        int b = cluster_start_[s], e = cluster_start_[s + 1];
+
+        if (m == elem_out)
+        {
+            cluster_keys<M>(x, b, e);
+            for (int r = b; r < e; ++r)
+            {
+                int i = cluster_points_[r];
+                double keep = dist2_[i];
+                if (key[r] < M::key_of(keep)) keep = min(keep, M::finish(key[r]));
+                delta += w_[i] * (keep - cluster_dist_[r]);
+            }
+            scanned_points_ += e - b;
+            continue;
+        }
+
+        double half = 0.5 * M::finish(features_->key<M>(elem_in, m));
+        int first = static_cast<int>(
+            upper_bound(cluster_dist_.begin() + b, cluster_dist_.begin() + e, half) -
+            cluster_dist_.begin());
+        pruned_points_ += first - b;
+        scanned_points_ += e - first;
+
+        cluster_keys<M>(x, first, e);
+        for (int r = first; r < e; ++r)
+        {
+            double cd = cluster_dist_[r];
+            if (!(key[r] < M::key_of(cd))) continue;
+            double dd = M::finish(key[r]);
+            if (dd < cd) delta += w_[cluster_points_[r]] * (dd - cd);
+        }
+    }
+    return delta / total_w_;
+}
+
+// Exact distance from i to its nearest medoid other than `skip` (-1: none skipped).
+double KMedoidsEvaluator::exact_nearest(int i, int skip) const
+{
+    double best = numeric_limits<double>::infinity();
+    for (int m : medoids_)
+        if (m != skip) best = min(best, exact_->distance(i, m));
+    return best;
+}
+
+// Exchange delta with every distance recomputed in double from the features
+// (float32 and quantized modes). The cached nearest medoid is exact unless the
+// second one is within 2e of it; those points, and the points whose nearest medoid
+// leaves (the cached second nearest may tie with the third), rescan the medoids.
+double KMedoidsEvaluator::exact_exchange_delta(int elem_in, int elem_out) const
+{
+    double delta = 0.0;
+    for (int i = 0; i < n_; ++i)
+    {
+        bool ambiguous = dist2_[i] - dist1_[i] < 2.0 * approx_error_;
+        double d1 = ambiguous ? exact_nearest(i, -1) : exact_->distance(i, near1_[i]);
+        double keep = (ambiguous || near1_[i] == elem_out) ? exact_nearest(i, elem_out) : d1;
+        delta += w_[i] * (min(keep, exact_->distance(elem_in, i)) - d1);
+    }
+    return delta / total_w_;
 }
@@ -2,14 +2,34 @@
 #include <algorithm>
 #include <cmath>
 #include <limits>
+#include <memory>
 #include <numeric>
+#include <random>
 #include <vector>
 
 #include "../../problems/Evaluator.h"
 #include "../../solutions/Solution.h"
+#include "Float32Distances.h"
+#include "MedoidScan.h"
+#include "NeighborIndex.h"
+#include "PointFeatures.h"
+#include "Quantized16Distances.h"
+#include "ThreadPool.h"
 
 using namespace std;
 
+// D must be symmetric: candidate distances are read from the candidate's row.
+// Alternatively distances are computed from the features on demand (use_features),
+// or read from a float32 (use_float32) or 16-bit quantized (use_quantized) matrix,
+// and D is dropped.
+//
+// The evaluator caches, for the last medoid set it saw, the nearest and second
+// nearest medoid of every point. Calls on a solution that differs from the cached
+// one by a few insertions/removals update the cache incrementally, so insertion,
+// removal and exchange costs are O(n) instead of O(nk). The distances from every
+// point to the current medoids are also kept in an n x k panel (one contiguous row
+// of k entries per point, updated in O(n) per medoid change), so re-finding a
+// point's next nearest medoid reads k adjacent values. Not thread-safe.
 class KMedoidsEvaluator : public Evaluator<int>
 {
    public:
@@ -21,21 +41,205 @@ class KMedoidsEvaluator : public Evaluator<int>
 
     double evaluate_insertion_cost(const int& elem, const Solution<int>& sol) const override;
 
+    // Insertion costs of `count` candidates (none of them in sol) into the same
+    // solution, out[j] for cands[j]; the cache is synced once for the whole batch.
+    void evaluate_insertion_costs(const int* cands, int count, const Solution<int>& sol,
+                                  double* out) const;
+
+    // Splits evaluate_insertion_costs over the pool's threads for batches of at least
+    // 2 * min_chunk candidates. Every candidate gets the same value as without the
+    // pool. The evaluator itself stays single-threaded: calls must not overlap.
+    void use_thread_pool(shared_ptr<ThreadPool> pool, int min_chunk = 64)
+    {
+        pool_ = move(pool);
+        pool_min_chunk_ = max(8, min_chunk);
+    }
+
     double evaluate_removal_cost(const int& elem, const Solution<int>& sol) const override;
 
+    // Best exchange of elem_in (not in sol) against every medoid of sol, in one pass
+    // over the points (FasterPAM): the delta shared by all removals plus, per medoid,
+    // the loss of reassigning its cluster. Returns the medoid to take out (-1 if none)
+    // with its exchange cost in best_delta.
+    int best_exchange(int elem_in, const Solution<int>& sol, double& best_delta) const;
+
+    // The same split without the minimum: exchanging elem_in with sol[j] costs
+    // shared + loss[j] (loss has sol.size() entries). Float32/quantized backends give
+    // screened values.
+    void exchange_losses(int elem_in, const Solution<int>& sol, double& shared,
+                         double* loss) const;
+
     double evaluate_exchange_cost(const int& elem_in, const int& elem_out,
                                   const Solution<int>& sol) const override;
 
+    // Sorted neighbor lists used to find the next nearest medoid of a point after
+    // its nearest or second nearest one is removed (forward walk from the removed
+    // medoid's rank). Truncated lists fall back to scanning the k medoids.
+    void use_rank_lists(shared_ptr<const NeighborIndex> ranks) { ranks_ = move(ranks); }
+
+    // Elkan/Hamerly-style pruning in evaluate_exchange_cost: a point i whose nearest
+    // medoid m satisfies d(in, m) >= 2 d(i, m) cannot move to `in` and is skipped.
+    // Only valid for metric distances (is_metric in Metrics.h).
+    void set_triangle_pruning(bool on) { triangle_pruning_ = on; }
+
+    // Feature-space backend: replaces D (which may then be empty at construction)
+    // and disables rank lists. Resets weights and the cache.
+    void use_features(shared_ptr<const PointFeatures> features);
+
+    // Float32 backend: screening reads the float matrix, sums stay in double, and
+    // exchange deltas that could be improving within the rounding bound are
+    // recomputed in double from `exact`, as is evaluate(). Disables rank lists; resets weights and the cache.
+    void use_float32(shared_ptr<const Float32Distances> dist32,
+                     shared_ptr<const PointFeatures> exact);
+
+    // Quantized backend: screening decodes 16-bit codes; exchange deltas that could
+    // be improving within the quantization error bound are recomputed exactly from
+    // `exact`, as is evaluate(). Disables rank lists; resets weights and the cache.
+    void use_quantized(shared_ptr<const Quantized16Distances> quant,
+                       shared_ptr<const PointFeatures> exact);
+
+    // Point multiplicities for weighted instances (e.g. coarsened point sets): the
+    // objective becomes sum_i w_i d(i, nearest) / sum_i w_i. Empty = unit weights.
+    void set_weights(const vector<double>& w);
+
+    // Mini-batch screening of exchange deltas. draw_sample picks about `batch` points
+    // stratified by nearest medoid in sol (proportional allocation, at least two per
+    // cluster when it has them); estimate_exchange_cost then estimates a delta from
+    // those points alone, with its standard error (stratified estimator with finite
+    // population correction) in std_err. Estimates refer to the solution of the last
+    // draw; accepted moves must still be confirmed with evaluate_exchange_cost.
+    void draw_sample(const Solution<int>& sol, int batch, mt19937& rng) const;
+    double estimate_exchange_cost(int elem_in, int elem_out, double& std_err) const;
+
+    // Read-only view of the cache for sol (syncs it): nearest medoid, distances to the
+    // nearest and second nearest, weights. Valid until the next call on another set.
+    struct NearestState
+    {
+        const int* near1;
+        const double* dist1;
+        const double* dist2;
+        const double* w;
+        double total_w;
+    };
+    NearestState nearest_state(const Solution<int>& sol) const;
+
+    // d(a, b) from the active storage (float32/quantized: the screening values).
+    double distance(int a, int b) const;
+
+    // Nearest medoid of every point for sol (syncs the cache).
+    const vector<int>& nearest_medoids(const Solution<int>& sol) const
+    {
+        sync_state(sol);
+        return near1_;
+    }
+
+    // Fraction of point visits in exchange evaluations skipped by the bounds.
+    double prune_hit_rate() const
+    {
+        long total = pruned_points_ + scanned_points_;
+        return total > 0 ? static_cast<double>(pruned_points_) / static_cast<double>(total) : 0.0;
+    }
+    void reset_prune_stats() const { pruned_points_ = scanned_points_ = 0; }
+
    private:
     vector<vector<double>> D_;
     int n_{0};
     int k_{0};
 
+    vector<double> w_;
+    double total_w_{0.0};
+
+    shared_ptr<const NeighborIndex> ranks_;
+
+    shared_ptr<const PointFeatures> features_;
+    mutable vector<double> key_row_;
+    mutable vector<double> x_buf_;
+
+    shared_ptr<const Float32Distances> dist32_;
+    shared_ptr<const Quantized16Distances> quant_;
+    shared_ptr<const PointFeatures> exact_;
+    double approx_error_{0.0};  // e: bound on |screened - exact| of one distance
+    double screen_tol_{0.0};    // screened exchange deltas below this are re-verified
+
+    shared_ptr<ThreadPool> pool_;
+    int pool_min_chunk_{64};
+
+    mutable bool state_valid_{false};
+    mutable vector<int> medoids_;
+    mutable vector<char> is_medoid_;
+    mutable vector<int> near1_;
+    mutable vector<int> near2_;
+    mutable vector<double> dist1_;
+    mutable vector<double> dist2_;
+    mutable vector<double> panel_;  // panel_[i * panel_stride_ + s] = d(i, medoids_[s])
+    mutable int panel_stride_{0};
+
+    // points grouped by nearest medoid (slot order of medoids_), each group sorted by
+    // increasing distance to it; rebuilt lazily after the medoid set changes
+    bool triangle_pruning_{true};
+    mutable bool clusters_valid_{false};
+    mutable vector<int> cluster_start_;
+    mutable vector<int> cluster_points_;
+    mutable vector<double> cluster_dist_;
+    mutable vector<double> cluster_cols_;  // feature mode: coordinates in cluster order
+    mutable vector<int> slot_of_;        // medoid -> slot, scratch of best_exchange
+    mutable vector<double> removal_loss_;
+    // screening sample: points grouped by stratum (cluster of sample_medoid_[h])
+    mutable vector<int> sample_points_;
+    mutable vector<int> sample_start_;
+    mutable vector<int> sample_medoid_;
+    mutable vector<double> stratum_size_;
+    mutable long pruned_points_{0};
+    mutable long scanned_points_{0};
+
     static bool contains(const Solution<int>& sol, int x)
     {
         return find(sol.begin(), sol.end(), x) != sol.end();
     }
 
-    double avg_from_medoids(const vector<int>& medoids) const;
-    double base_avg(const Solution<int>& sol) const;
+    void sync_state(const Solution<int>& sol) const;
+    void rebuild_state(const Solution<int>& sol) const;
+    void add_medoid(int p) const;
+
+    // Distance sources for the loops shared by all backends (defined in the .cpp).
+    struct DenseRow;
+    struct FloatRow;
+    struct QuantRow;
+    template <class M>
+    struct FeatureRow;
+
+    // policy keys from p in key_row_, valid until the next call
+    template <class M>
+    FeatureRow<M> feature_row(int p) const;
+    QuantRow quant_row(int p) const;
+
+    template <class Row>
+    void add_medoid_from(int p, int slot, const Row& row) const;
+    double insertion_delta_of(int elem, bool empty) const;
+    template <class Row>
+    double insertion_delta(const Row& row, bool empty) const;
+    template <class Row>
+    void insertion_deltas(const Row* rows, int m, double* out) const;  // m <= 8
+    void insertion_costs_range(const int* cands, int count, bool empty, double* out,
+                               double* keys) const;
+    template <class Row>
+    double exchange_delta(const Row& row, int elem_out) const;
+    double exchange_losses_of(int elem_in, const Solution<int>& sol) const;
+    template <class Row>
+    double exchange_losses_from(const Row& row) const;
+    template <class Dist>
+    double sampled_exchange_delta(const Dist& dist_in, int elem_out, double& std_err) const;
+
+    template <class M>
+    void cluster_keys(const double* x, int b, int e) const;
+    template <class M>
+    double exchange_delta_clustered(int elem_in, int elem_out) const;
+    double exact_nearest(int i, int skip) const;
+    double exact_exchange_delta(int elem_in, int elem_out) const;
+    void remove_medoid(int q) const;
+    void build_clusters() const;
+
+    void grow_panel(int stride) const;
+    int next_medoid_after(int i, double from_dist, int exclude, double& d) const;
+    int scan_nearest_excluding(int i, int exclude, double& best_d) const;
 };
@@ -0,0 +1,72 @@
+#pragma once
+#include <limits>
+#include <utility>
+
+using namespace std;
+
+// Nearest-medoid reductions over k candidate slots. dist(s) gives the distance to
+// the medoid in slot s; the result is the first slot with the smallest distance (or
+// -1 when none is below infinity), with that distance in best_d.
+//
+// For the common k <= 8 the slot count is a template parameter and the compare
+// chain is expanded at compile time (one step per slot, running minimum and slot
+// in registers). Larger k use the runtime-length loop.
+
+template <class Dist, size_t... S>
+int nearest_slot_unrolled(const Dist& dist, double& best_d, index_sequence<S...>)
+{
+    double m = numeric_limits<double>::infinity();
+    int best = -1;
+    // written as selects so every step compiles to a compare and two conditional moves
+    auto step = [&](int s)
+    {
+        double v = dist(s);
+        bool lt = v < m;
+        best = lt ? s : best;
+        m = lt ? v : m;
+    };
+    (step(static_cast<int>(S)), ...);
+    best_d = m;
+    return best;
+}
+
+template <int K, class Dist>
+int nearest_slot_fixed(const Dist& dist, double& best_d)
+{
+    return nearest_slot_unrolled(dist, best_d, make_index_sequence<K>{});
+}
+
+template <class Dist>
+int nearest_slot_generic(int k, const Dist& dist, double& best_d)
+{
+    double m = numeric_limits<double>::infinity();
+    int best = -1;
+    for (int s = 0; s < k; ++s)
+    {
+        double v = dist(s);
+        if (v < m)
+        {
+            m = v;
+            best = s;
+        }
+    }
+    best_d = m;
+    return best;
+}
+
+template <class Dist>
+int nearest_slot(int k, const Dist& dist, double& best_d)
+{
+    switch (k)
+    {
+        case 1: return nearest_slot_fixed<1>(dist, best_d);
+        case 2: return nearest_slot_fixed<2>(dist, best_d);
+        case 3: return nearest_slot_fixed<3>(dist, best_d);
+        case 4: return nearest_slot_fixed<4>(dist, best_d);
+        case 5: return nearest_slot_fixed<5>(dist, best_d);
+        case 6: return nearest_slot_fixed<6>(dist, best_d);
+        case 7: return nearest_slot_fixed<7>(dist, best_d);
+        case 8: return nearest_slot_fixed<8>(dist, best_d);
+        default: return nearest_slot_generic(k, dist, best_d);
+    }
+}
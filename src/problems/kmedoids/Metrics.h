@@ -0,0 +1,108 @@
+#pragma once
+#include <cmath>
+#include <string>
+
+using namespace std;
+
+// Point-to-point dissimilarities as compile-time policies. A distance is accumulated
+// dimension by dimension into a key, key = combine(key, term(a_j, b_j)) starting from
+// 0, and distance = finish(key). finish is increasing, so keys compare like distances
+// and key_of(bound) lets hot loops test a bound before paying for finish (the square
+// root of Euclidean). Every backend accumulates in dimension order, so the same pair
+// gets the same value from the matrix and from the features.
+//
+// metric: the triangle inequality holds (required by triangle pruning).
+// unit_rows: rows are scaled to unit length before use (cosine).
+
+struct Euclidean
+{
+    static constexpr bool metric = true;
+    static constexpr bool unit_rows = false;
+    static double term(double a, double b) { return (a - b) * (a - b); }
+    static double combine(double key, double t) { return key + t; }
+    static double finish(double key) { return sqrt(key); }
+    static double key_of(double dist) { return dist * dist; }
+};
+
+struct SqEuclidean
+{
+    static constexpr bool metric = false;
+    static constexpr bool unit_rows = false;
+    static double term(double a, double b) { return (a - b) * (a - b); }
+    static double combine(double key, double t) { return key + t; }
+    static double finish(double key) { return key; }
+    static double key_of(double dist) { return dist; }
+};
+
+struct Manhattan
+{
+    static constexpr bool metric = true;
+    static constexpr bool unit_rows = false;
+    static double term(double a, double b) { return fabs(a - b); }
+    static double combine(double key, double t) { return key + t; }
+    static double finish(double key) { return key; }
+    static double key_of(double dist) { return dist; }
+};
+
+struct Chebyshev
+{
+    static constexpr bool metric = true;
+    static constexpr bool unit_rows = false;
+    static double term(double a, double b) { return fabs(a - b); }
+    static double combine(double key, double t) { return key < t ? t : key; }
+    static double finish(double key) { return key; }
+    static double key_of(double dist) { return dist; }
+};
+
+// 1 - cos(a, b), computed on unit rows as |a - b|^2 / 2 (same value, no division per
+// pair). A zero row stays zero and is at distance 1/2 from every unit row.
+struct Cosine
+{
+    static constexpr bool metric = false;
+    static constexpr bool unit_rows = true;
+    static double term(double a, double b) { return (a - b) * (a - b); }
+    static double combine(double key, double t) { return key + t; }
+    static double finish(double key) { return 0.5 * key; }
+    static double key_of(double dist) { return 2.0 * dist; }
+};
+
+enum class Metric
+{
+    Euclidean,
+    SqEuclidean,
+    Manhattan,
+    Chebyshev,
+    Cosine
+};
+
+// Calls f with the policy object of m; every call site is instantiated once per
+// metric, so the choice costs one switch per call instead of one per distance.
+template <class F>
+auto with_metric(Metric m, F&& f)
+{
+    switch (m)
+    {
+        case Metric::SqEuclidean: return f(SqEuclidean{});
+        case Metric::Manhattan: return f(Manhattan{});
+        case Metric::Chebyshev: return f(Chebyshev{});
+        case Metric::Cosine: return f(Cosine{});
+        default: return f(Euclidean{});
+    }
+}
+
+inline bool is_metric(Metric m)
+{
+    return with_metric(m, [](auto policy) { return decltype(policy)::metric; });
+}
+
+inline string metric_name(Metric m)
+{
+    switch (m)
+    {
+        case Metric::SqEuclidean: return "sqeuclidean";
+        case Metric::Manhattan: return "manhattan";
+        case Metric::Chebyshev: return "chebyshev";
+        case Metric::Cosine: return "cosine";
+        default: return "euclidean";
+    }
+}
@@ -0,0 +1,23 @@
+#include "NeighborIndex.h"
+
+#include <algorithm>
+#include <numeric>
+
+NeighborIndex::NeighborIndex(const vector<vector<double>>& D, int L)
+    : n_(static_cast<int>(D.size())), L_(max(0, min(L, static_cast<int>(D.size()) - 1)))
+{
+    nbrs_.resize(n_);
+
+    vector<int> order(n_);
+    for (int i = 0; i < n_; ++i)
+    {
+        const auto& row = D[i];
+        iota(order.begin(), order.end(), 0);
+        swap(order[i], order.back());
+
+        auto by_dist = [&row](int a, int b) { return row[a] < row[b] || (row[a] == row[b] && a < b); };
+        partial_sort(order.begin(), order.begin() + L_, order.end() - 1, by_dist);
+
+        nbrs_[i].assign(order.begin(), order.begin() + L_);
+    }
+}
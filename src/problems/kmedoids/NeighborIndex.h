@@ -0,0 +1,22 @@
+#pragma once
+#include <vector>
+
+using namespace std;
+
+// Per-point list of the L nearest other points, sorted by increasing distance.
+// Built once per instance; used to restrict swap neighborhoods to nearby candidates.
+class NeighborIndex
+{
+   public:
+    NeighborIndex(const vector<vector<double>>& D, int L);
+
+    int n() const { return n_; }
+    int L() const { return L_; }
+
+    const vector<int>& neighbors(int i) const { return nbrs_[i]; }
+
+   private:
+    int n_{0};
+    int L_{0};
+    vector<vector<int>> nbrs_;
+};
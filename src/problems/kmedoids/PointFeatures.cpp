@@ -0,0 +1,30 @@
+#include "PointFeatures.h"
+
+#include <cmath>
+
+PointFeatures::PointFeatures(const vector<vector<double>>& X, Metric metric)
+    : n_(static_cast<int>(X.size())),
+      d_(X.empty() ? 0 : static_cast<int>(X[0].size())),
+      metric_(metric)
+{
+    bool unit_rows = with_metric(metric_, [](auto policy) { return decltype(policy)::unit_rows; });
+
+    cols_.resize(static_cast<size_t>(n_) * d_);
+    for (int i = 0; i < n_; ++i)
+    {
+        double scale = 1.0;
+        if (unit_rows)
+        {
+            double norm = 0.0;
+            for (int j = 0; j < d_; ++j) norm += X[i][j] * X[i][j];
+            if (norm > 0.0) scale = 1.0 / sqrt(norm);
+        }
+        for (int j = 0; j < d_; ++j) cols_[static_cast<size_t>(j) * n_ + i] = X[i][j] * scale;
+    }
+}
+
+double PointFeatures::distance(int a, int b) const
+{
+    return with_metric(metric_, [&](auto policy)
+                       { return decltype(policy)::finish(key<decltype(policy)>(a, b)); });
+}
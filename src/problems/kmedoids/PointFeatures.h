@@ -0,0 +1,56 @@
+#pragma once
+#include <vector>
+
+#include "Metrics.h"
+
+using namespace std;
+
+// Feature matrix kept in structure-of-arrays layout (one contiguous column per
+// dimension), used instead of the n x n distance matrix when d is small: O(nd)
+// memory and no O(n^2 d) startup. Distances follow the metric policy (Metrics.h),
+// accumulated over dimensions in the same order for every backend, so
+// pairwise_distances (built from these rows) and the on-the-fly paths agree exactly.
+class PointFeatures
+{
+   public:
+    explicit PointFeatures(const vector<vector<double>>& X, Metric metric = Metric::Euclidean);
+
+    int n() const { return n_; }
+    int d() const { return d_; }
+    Metric metric() const { return metric_; }
+
+    const double* column(int j) const { return &cols_[static_cast<size_t>(j) * n_]; }
+
+    // Policy key of the pair (e.g. the squared distance for Euclidean); M must match
+    // metric().
+    template <class M>
+    double key(int a, int b) const
+    {
+        double s = 0.0;
+        const double* c = cols_.data();
+        for (int j = 0; j < d_; ++j, c += n_) s = M::combine(s, M::term(c[a], c[b]));
+        return s;
+    }
+
+    double distance(int a, int b) const;
+
+    // out[i] = key<M>(p, i) for every point i in [begin, n) (out must hold n values);
+    // one unit-stride pass per dimension, which the compiler vectorizes.
+    template <class M>
+    void keys_from(int p, double* out, int begin = 0) const
+    {
+        for (int i = begin; i < n_; ++i) out[i] = 0.0;
+        for (int j = 0; j < d_; ++j)
+        {
+            const double* c = &cols_[static_cast<size_t>(j) * n_];
+            const double x = c[p];
+            for (int i = begin; i < n_; ++i) out[i] = M::combine(out[i], M::term(c[i], x));
+        }
+    }
+
+   private:
+    int n_{0};
+    int d_{0};
+    Metric metric_{Metric::Euclidean};
+    vector<double> cols_;  // cols_[j * n_ + i] = X[i][j] (scaled to unit rows for cosine)
+};
@@ -0,0 +1,30 @@
+#include "Quantized16Distances.h"
+
+#include <algorithm>
+#include <cmath>
+
+Quantized16Distances::Quantized16Distances(const PointFeatures& features)
+    : n_(features.n()), codes_(static_cast<size_t>(n_) * n_, 0), scale_(n_, 0.0)
+{
+    vector<double> row(n_);
+    for (int i = 0; i < n_; ++i)
+    {
+        with_metric(features.metric(),
+                    [&](auto policy)
+                    {
+                        using M = decltype(policy);
+                        features.keys_from<M>(i, row.data());
+                        for (int j = 0; j < n_; ++j) row[j] = (i == j) ? 0.0 : M::finish(row[j]);
+                    });
+
+        double row_max = 0.0;
+        for (int j = 0; j < n_; ++j) row_max = max(row_max, row[j]);
+
+        double s = (row_max > 0.0) ? row_max / 65535.0 : 1.0;
+        scale_[i] = s;
+        max_error_ = max(max_error_, 0.5 * s);
+
+        uint16_t* out = &codes_[static_cast<size_t>(i) * n_];
+        for (int j = 0; j < n_; ++j) out[j] = static_cast<uint16_t>(lround(row[j] / s));
+    }
+}
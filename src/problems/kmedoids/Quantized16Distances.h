@@ -0,0 +1,33 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "PointFeatures.h"
+
+using namespace std;
+
+// n x n distance matrix (in the features' metric) quantized to 16-bit codes with one
+// scale per row (row maximum / 65535): a quarter of the memory of doubles. Every
+// entry is within max_error() of the exact distance; the evaluator uses that bound to
+// decide which screened moves must be re-checked against exact distances.
+class Quantized16Distances
+{
+   public:
+    explicit Quantized16Distances(const PointFeatures& features);
+
+    int n() const { return n_; }
+
+    const uint16_t* codes(int i) const { return &codes_[static_cast<size_t>(i) * n_]; }
+    double scale(int i) const { return scale_[i]; }
+
+    double distance(int a, int b) const { return codes(a)[b] * scale_[a]; }
+
+    double max_error() const { return max_error_; }
+
+   private:
+    int n_{0};
+    vector<uint16_t> codes_;
+    vector<double> scale_;
+    double max_error_{0.0};
+};
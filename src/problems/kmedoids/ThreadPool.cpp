@@ -0,0 +1,91 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <map>
+
+ThreadPool::ThreadPool(int threads)
+{
+    if (threads <= 0) threads = max(1, static_cast<int>(thread::hardware_concurrency()));
+    workers_.reserve(threads - 1);
+    for (int t = 1; t < threads; ++t) workers_.emplace_back([this] { worker_loop(); });
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        lock_guard<mutex> lock(mu_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& t : workers_) t.join();
+}
+
+shared_ptr<ThreadPool> ThreadPool::shared(int threads)
+{
+    static mutex mu;
+    static map<int, shared_ptr<ThreadPool>> pools;
+    if (threads <= 0) threads = max(1, static_cast<int>(thread::hardware_concurrency()));
+    lock_guard<mutex> lock(mu);
+    auto& pool = pools[threads];
+    if (!pool) pool = make_shared<ThreadPool>(threads);
+    return pool;
+}
+
+void ThreadPool::parallel_for(int count, int chunk, const function<void(int, int)>& body)
+{
+    if (count <= 0) return;
+    chunk = max(1, chunk);
+    const int chunks = (count + chunk - 1) / chunk;
+    if (workers_.empty() || chunks == 1)
+    {
+        for (int b = 0; b < count; b += chunk) body(b, min(count, b + chunk));
+        return;
+    }
+
+    lock_guard<mutex> call(call_mu_);
+    {
+        lock_guard<mutex> lock(mu_);
+        body_ = &body;
+        count_ = count;
+        chunk_ = chunk;
+        chunks_ = chunks;
+        next_.store(0);
+        running_ = static_cast<int>(workers_.size());
+        ++generation_;
+    }
+    wake_.notify_all();
+
+    run_chunks();
+
+    unique_lock<mutex> lock(mu_);
+    done_.wait(lock, [this] { return running_ == 0; });
+    body_ = nullptr;
+}
+
+void ThreadPool::run_chunks()
+{
+    for (int c = next_.fetch_add(1); c < chunks_; c = next_.fetch_add(1))
+    {
+        const int b = c * chunk_;
+        (*body_)(b, min(count_, b + chunk_));
+    }
+}
+
+void ThreadPool::worker_loop()
+{
+    long seen = 0;
+    for (;;)
+    {
+        {
+            unique_lock<mutex> lock(mu_);
+            wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+            if (stop_) return;
+            seen = generation_;
+        }
+        run_chunks();
+        {
+            lock_guard<mutex> lock(mu_);
+            if (--running_ == 0) done_.notify_one();
+        }
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Fixed set of worker threads that run one blocking parallel_for at a time. The
+// range is cut into fixed chunks and every chunk writes only its own indices, so the
+// result does not depend on which thread ran which chunk. The calling thread works
+// on chunks too; calls from several threads are serialized.
+class ThreadPool
+{
+   public:
+    // threads counts the caller; <= 0 uses the hardware concurrency.
+    explicit ThreadPool(int threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int size() const { return static_cast<int>(workers_.size()) + 1; }
+
+    // Calls body(begin, end) for [0, count) in chunks of `chunk` indices and returns
+    // once all of them are done.
+    void parallel_for(int count, int chunk, const function<void(int, int)>& body);
+
+    // Process-wide pool of `threads` threads (<= 0: hardware concurrency), created by
+    // the first call for that size and shared by every later call asking for it.
+    static shared_ptr<ThreadPool> shared(int threads = 0);
+
+   private:
+    vector<thread> workers_;
+    mutex call_mu_;  // one parallel_for at a time
+
+    mutex mu_;
+    condition_variable wake_;
+    condition_variable done_;
+    long generation_{0};
+    int running_{0};  // workers still inside the current job
+    bool stop_{false};
+
+    const function<void(int, int)>* body_{nullptr};
+    int count_{0};
+    int chunk_{1};
+    int chunks_{0};
+    atomic<int> next_{0};
+
+    void worker_loop();
+    void run_chunks();
+};
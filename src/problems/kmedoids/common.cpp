@@ -6,6 +6,8 @@
 #include <fstream>
 #include <sstream>
 
+#include "problems/kmedoids/PointFeatures.h"
+
 using namespace std;
 
 inline void ltrim(string& s)
@@ -145,29 +147,32 @@ vector<vector<double>>& zscore_inplace(vector<vector<double>>& X, int ddof)
     return X;
 }
 
-vector<vector<double>> pairwise_euclidean(const vector<vector<double>>& X)
+vector<vector<double>> pairwise_distances(const vector<vector<double>>& X, Metric metric)
 {
-    size_t n = X.size();
+    PointFeatures F(X, metric);
+    int n = F.n();
     vector<vector<double>> D(n, vector<double>(n, 0.0));
 
-    for (size_t i = 0; i < n; ++i)
-    {
-        auto& xi = X[i];
-
-        for (size_t j = i + 1; j < n; ++j)
-        {
-            auto& xj = X[j];
-            double s = 0.0;
-            size_t d = min(xi.size(), xj.size());
-            for (size_t k = 0; k < d; ++k)
-            {
-                double diff = xi[k] - xj[k];
-                s += diff * diff;
-            }
-            double dist = sqrt(s);
-            D[i][j] = dist;
-            D[j][i] = dist;
-        }
-    }
+    with_metric(metric,
+                [&](auto policy)
+                {
+                    using M = decltype(policy);
+                    for (int i = 0; i < n; ++i)
+                    {
+                        // keys of the pairs (i, j > i) into D[i], then finished and mirrored
+                        double* row = D[i].data();
+                        F.keys_from<M>(i, row, i + 1);
+                        for (int j = i + 1; j < n; ++j)
+                        {
+                            row[j] = M::finish(row[j]);
+                            D[j][i] = row[j];
+                        }
+                    }
+                });
     return D;
 }
+
+vector<vector<double>> pairwise_euclidean(const vector<vector<double>>& X)
+{
+    return pairwise_distances(X, Metric::Euclidean);
+}
@@ -1,6 +1,8 @@
 #include <string>
 #include <vector>
 
+#include "problems/kmedoids/Metrics.h"
+
 using namespace std;
 
 double to_float(string token, char decimal = ',');
@@ -9,4 +11,8 @@ vector<vector<double>> load_i_dataset(const string& path, char sep = ';', char d
 
 vector<vector<double>>& zscore_inplace(vector<vector<double>>& X, int ddof = 1);
 
+// Full n x n matrix under `metric`, computed row by row with the structure-of-arrays
+// kernel of PointFeatures (identical values to the on-the-fly paths).
+vector<vector<double>> pairwise_distances(const vector<vector<double>>& X, Metric metric);
+
 vector<vector<double>> pairwise_euclidean(const vector<vector<double>>& X);
@@ -0,0 +1,121 @@
+#include "CLARA_KMedoids.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+
+#include "../../../metaheuristics/grasp/AbstractGRASP.h"
+
+CLARA_KMedoids::CLARA_KMedoids(const vector<vector<double>>& X, int k, int sample_size,
+                               int num_samples, SubSolver solver, TargetCheck reached_target,
+                               Metric metric)
+    : features_(X, metric),
+      n_(static_cast<int>(X.size())),
+      k_(k),
+      s_(min(static_cast<int>(X.size()), sample_size > 0 ? sample_size : default_sample_size(k))),
+      num_samples_(max(1, num_samples)),
+      solver_(move(solver)),
+      reached_target_(move(reached_target))
+{
+}
+
+double CLARA_KMedoids::assignment_cost(const vector<int>& medoids) const
+{
+    if (medoids.empty()) return numeric_limits<double>::infinity();
+
+    // one vectorized pass of keys per medoid; finish only each point's smallest key
+    return with_metric(features_.metric(),
+                       [&](auto policy)
+                       {
+                           using M = decltype(policy);
+                           vector<double> best(n_, numeric_limits<double>::infinity());
+                           vector<double> key(n_);
+                           for (int m : medoids)
+                           {
+                               features_.keys_from<M>(m, key.data());
+                               for (int i = 0; i < n_; ++i) best[i] = min(best[i], key[i]);
+                           }
+
+                           double total = 0.0;
+                           for (int i = 0; i < n_; ++i) total += M::finish(best[i]);
+                           return total / static_cast<double>(n_);
+                       });
+}
+
+// Random subsample of size s_ that always contains `keep` (the best medoids so far,
+// as in the original CLARA), drawn with a partial Fisher-Yates shuffle.
+vector<int> CLARA_KMedoids::draw_sample(const vector<int>& keep) const
+{
+    auto& rng = AbstractGRASP<int>::rng;
+
+    vector<int> pool(n_);
+    iota(pool.begin(), pool.end(), 0);
+
+    int filled = 0;
+    for (int m : keep)
+    {
+        auto it = find(pool.begin() + filled, pool.end(), m);
+        if (it != pool.end()) swap(pool[filled++], *it);
+    }
+    for (; filled < s_; ++filled)
+    {
+        uniform_int_distribution<int> dist(filled, n_ - 1);
+        swap(pool[filled], pool[dist(rng)]);
+    }
+    pool.resize(s_);
+    return pool;
+}
+
+Solution<int> CLARA_KMedoids::solve()
+{
+    auto t0 = chrono::steady_clock::now();
+    auto elapsed_ms = [&t0]()
+    {
+        return static_cast<long>(
+            chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - t0).count());
+    };
+
+    Solution<int> best;
+    vector<vector<double>> Ds(s_, vector<double>(s_, 0.0));
+
+    for (samples_run = 0; samples_run < num_samples_; ++samples_run)
+    {
+        vector<int> sample = draw_sample(vector<int>(best.begin(), best.end()));
+
+        for (int a = 0; a < s_; ++a)
+        {
+            for (int b = a + 1; b < s_; ++b)
+            {
+                double d = features_.distance(sample[a], sample[b]);
+                Ds[a][b] = d;
+                Ds[b][a] = d;
+            }
+        }
+
+        Solution<int> local = solver_(Ds, k_);
+        vector<int> medoids;
+        medoids.reserve(local.size());
+        for (int idx : local) medoids.push_back(sample[idx]);
+
+        double c = assignment_cost(medoids);
+        if (c < best.cost)
+        {
+            best.assign(medoids.begin(), medoids.end());
+            best.cost = c;
+            time_to_solution_ms = elapsed_ms();
+        }
+
+        if (reached_target_ && reached_target_(best.cost))
+        {
+            if (time_to_target_ms < 0) time_to_target_ms = elapsed_ms();
+            ++samples_run;
+            break;
+        }
+    }
+
+    execution_time_ms = elapsed_ms();
+    return best;
+}
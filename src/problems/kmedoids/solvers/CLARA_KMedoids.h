@@ -0,0 +1,48 @@
+#pragma once
+#include <functional>
+#include <vector>
+
+#include "../../../solutions/Solution.h"
+#include "../PointFeatures.h"
+
+using namespace std;
+
+// CLARA-style driver for large n: runs a k-medoids solver on random subsamples
+// (each with its own s x s distance matrix), assigns every point to each candidate
+// medoid set computing distances on the fly from the features, and keeps the best
+// candidate by the true objective. Memory is O(s^2 + nd) instead of O(n^2).
+class CLARA_KMedoids
+{
+   public:
+    // Solves k-medoids on a subsample distance matrix; returns indices into it.
+    using SubSolver = function<Solution<int>(vector<vector<double>>& Ds, int k)>;
+
+    // Optional early stop once the best true cost satisfies it.
+    using TargetCheck = function<bool(double)>;
+
+    CLARA_KMedoids(const vector<vector<double>>& X, int k, int sample_size, int num_samples,
+                   SubSolver solver, TargetCheck reached_target = nullptr,
+                   Metric metric = Metric::Euclidean);
+
+    Solution<int> solve();
+
+    // Average distance of every point to its nearest medoid (true objective).
+    double assignment_cost(const vector<int>& medoids) const;
+
+    static int default_sample_size(int k) { return 40 + 2 * k; }
+
+    int sample_size() const { return s_; }
+
+    int samples_run{0};
+    long execution_time_ms{0};
+    long time_to_solution_ms{-1};
+    long time_to_target_ms{-1};
+
+   private:
+    PointFeatures features_;
+    int n_, k_, s_, num_samples_;
+    SubSolver solver_;
+    TargetCheck reached_target_;
+
+    vector<int> draw_sample(const vector<int>& keep) const;
+};
@@ -1,13 +1,12 @@
 #include "GRASP_KMedoids.h"
 
+#include <cmath>
 #include <iostream>
 #include <numeric>
 #include <unordered_set>
 
 GRASP_KMedoids::GRASP_KMedoids(double alpha, int iterations, const vector<vector<double>>& D, int k)
     : AbstractGRASP<int>(evaluator_, alpha, iterations),
-      D_(D),
-      n_(static_cast<int>(D.size())),
       k_(k),
       evaluator_(D, k)
 {
@@ -15,7 +14,7 @@ GRASP_KMedoids::GRASP_KMedoids(double alpha, int iterations, const vector<vector
 
 vector<int> GRASP_KMedoids::makeCL()
 {
-    vector<int> cl(n_);
+    vector<int> cl(evaluator_.get_domain_size());
     iota(cl.begin(), cl.end(), 0);
     return cl;
 }
@@ -67,11 +66,13 @@ Solution<int> GRASP_KMedoids::constructiveHeuristic()
         double max_dc = -numeric_limits<double>::infinity();
         vector<double> deltas(CL.size(), 0.0);
 
-        for (size_t i = 0; i < CL.size(); ++i)
+        // batched (and, with a thread pool, parallel) evaluation; the reduction stays
+        // on this thread in CL order, so the threshold and the RCL draw are the same
+        // for every thread count
+        evaluator_.evaluate_insertion_costs(CL.data(), static_cast<int>(CL.size()), *sol,
+                                            deltas.data());
+        for (double dc : deltas)
         {
-            int c = CL[i];
-            double dc = ObjFunction.evaluate_insertion_cost(c, *sol);
-            deltas[i] = dc;
             if (dc < min_dc) 
                 min_dc = dc;
             if (dc > max_dc) 
@@ -118,48 +119,306 @@ Solution<int> GRASP_KMedoids::constructiveHeuristic()
 
 Solution<int> GRASP_KMedoids::localSearch()
 {
-    double eps = 1e-12;
-    bool improved = true;
+    if (ls_policy_ == LSPolicy::EagerSwap) return eagerLocalSearch();
+    if (ls_policy_ == LSPolicy::Sampled) return sampledLocalSearch();
+    if (screen_batch_ > 0 && ObjFunction.get_domain_size() >= 4 * screen_batch_)
+        return screenedLocalSearch();
+    if (cached_gains_) return cachedLocalSearch();
+
+    int best_in, best_out;
+    while (exactBestExchange(best_in, best_out))
+    {
+        applyExchange(best_in, best_out);
+        if (descentStep()) break;
+    }
+
+    return *sol;
+}
+
+// Best improving exchange over the full neighborhood; false if there is none.
+bool GRASP_KMedoids::exactBestExchange(int& best_in, int& best_out)
+{
+    const double eps = 1e-12;
+    double best_dc = 0.0;
+    best_in = -1;
+    best_out = -1;
+
+    updateCL();
+    vector<int> out_list(sol->begin(), sol->end());
+    for (int cin : CL)
+    {
+        for (int cout : out_list)
+        {
+            double dc = ObjFunction.evaluate_exchange_cost(cin, cout, *sol);
+            if (dc < best_dc - eps)
+            {
+                best_dc = dc;
+                best_in = cin;
+                best_out = cout;
+            }
+        }
+    }
+    return best_in != -1;
+}
+
+void GRASP_KMedoids::applyExchange(int elem_in, int elem_out)
+{
+    auto oit = find(sol->begin(), sol->end(), elem_out);
+    if (oit != sol->end()) sol->erase(oit);
+    sol->add(elem_in);
+
+    CL.push_back(elem_out);
+    auto cit = find(CL.begin(), CL.end(), elem_in);
+    if (cit != CL.end()) CL.erase(cit);
+
+    sol->cost = ObjFunction.evaluate(*sol);
+}
+
+Solution<int> GRASP_KMedoids::screenedLocalSearch()
+{
+    const double eps = 1e-12;
+    const double z = 2.0;
+
+    struct Screened
+    {
+        double est;
+        int in, out;
+    };
+    vector<Screened> promising;
 
-    while (improved)
+    while (true)
     {
-        improved = false;
+        updateCL();
+        evaluator_.draw_sample(*sol, screen_batch_, rng_);
+
+        promising.clear();
+        for (int cin : CL)
+        {
+            for (int cout : *sol)
+            {
+                double se;
+                double est = evaluator_.estimate_exchange_cost(cin, cout, se);
+                if (est - z * se < -eps) promising.push_back({est, cin, cout});
+            }
+        }
+
+        sort(promising.begin(), promising.end(),
+             [](const Screened& a, const Screened& b) { return a.est < b.est; });
+
+        // best of the first `confirm` estimates; past those, the first confirmed one
         double best_dc = 0.0;
         int best_in = -1, best_out = -1;
+        for (size_t j = 0; j < promising.size(); ++j)
+        {
+            if (best_in != -1 && j >= (size_t) screen_confirm_) break;
+            double dc = ObjFunction.evaluate_exchange_cost(promising[j].in, promising[j].out, *sol);
+            if (dc < best_dc - eps)
+            {
+                best_dc = dc;
+                best_in = promising[j].in;
+                best_out = promising[j].out;
+            }
+        }
 
-        updateCL();
-        vector<int> out_list(sol->begin(), sol->end());
-        vector<int> in_list = CL;
+        if (best_in == -1 && !exactBestExchange(best_in, best_out)) break;
+        applyExchange(best_in, best_out);
+        if (descentStep()) break;
+    }
+
+    return *sol;
+}
+
+Solution<int> GRASP_KMedoids::eagerLocalSearch()
+{
+    const double eps = 1e-12;
+
+    updateCL();
+    const int m = (int) CL.size();
+    if (m == 0 || sol->empty()) return *sol;
+
+    uniform_int_distribution<int> start(0, m - 1);
+    int pos = start(rng_);
+    int idle = 0;
 
-        for (int cin : in_list)
+    while (idle < m)
+    {
+        const int cin = CL[pos];
+        double dc;
+        int cout = evaluator_.best_exchange(cin, *sol, dc);
+        if (cout >= 0 && dc < -eps)
         {
-            for (int cout : out_list)
+            *find(sol->begin(), sol->end(), cout) = cin;
+            CL[pos] = cout;
+            sol->cost = ObjFunction.evaluate(*sol);
+            idle = 0;
+            if (descentStep()) break;
+        }
+        else
+        {
+            ++idle;
+        }
+        pos = (pos + 1 == m) ? 0 : pos + 1;
+    }
+
+    return *sol;
+}
+
+Solution<int> GRASP_KMedoids::sampledLocalSearch()
+{
+    const double eps = 1e-12;
+
+    updateCL();
+    const int m = (int) CL.size();
+    const int k = (int) sol->size();
+    if (m == 0 || k == 0) return *sol;
+
+    long max_neighbor = max_neighbor_;
+    if (max_neighbor <= 0) max_neighbor = max(250L, (long) ceil(0.0125 * (double) k * m));
+
+    uniform_int_distribution<int> pick_in(0, m - 1), pick_out(0, k - 1);
+    long fails = 0;
+
+    while (fails < max_neighbor)
+    {
+        const int a = pick_in(rng_), s = pick_out(rng_);
+        double dc = ObjFunction.evaluate_exchange_cost(CL[a], (*sol)[s], *sol);
+        if (dc < -eps)
+        {
+            const int cout = (*sol)[s];
+            (*sol)[s] = CL[a];
+            CL[a] = cout;
+            sol->cost = ObjFunction.evaluate(*sol);
+            fails = 0;
+            if (descentStep()) break;
+        }
+        else
+        {
+            ++fails;
+        }
+    }
+
+    return *sol;
+}
+
+Solution<int> GRASP_KMedoids::cachedLocalSearch()
+{
+    const double eps = 1e-12;
+
+    updateCL();
+    const int m = (int) CL.size();
+    const int k = (int) sol->size();
+    if (m == 0 || k == 0) return *sol;
+    const int n = ObjFunction.get_domain_size();
+
+    // row a: exchanging CL[a] with (*sol)[j] costs shared[a] + loss[a * k + j]
+    vector<double> shared(m), loss((size_t) m * k);
+    auto refresh = [&](int a)
+    { evaluator_.exchange_losses(CL[a], *sol, shared[a], &loss[(size_t) a * k]); };
+    for (int a = 0; a < m; ++a) refresh(a);
+    // rows holding a pair that failed confirmation; refreshed after the next swap
+    vector<char> blocked(m, 0);
+
+    vector<int> slot_of(n, -1);
+    for (int j = 0; j < k; ++j) slot_of[(*sol)[j]] = j;
+
+    // per point: slot of the nearest medoid and the two distances its rows were built on
+    vector<int> p_slot(n);
+    vector<double> p_d1(n), p_d2(n);
+    auto st = evaluator_.nearest_state(*sol);
+    for (int i = 0; i < n; ++i)
+    {
+        p_slot[i] = slot_of[st.near1[i]];
+        p_d1[i] = st.dist1[i];
+        p_d2[i] = st.dist2[i];
+    }
+
+    vector<int> changed;
+    while (true)
+    {
+        double best = -eps;
+        int ba = -1, bj = -1;
+        for (int a = 0; a < m; ++a)
+        {
+            const double* row = &loss[(size_t) a * k];
+            for (int j = 0; j < k; ++j)
             {
-                double dc = ObjFunction.evaluate_exchange_cost(cin, cout, *sol);
-                if (dc < best_dc - eps)
+                double v = shared[a] + row[j];
+                if (v < best)
                 {
-                    best_dc = dc;
-                    best_in = cin;
-                    best_out = cout;
+                    best = v;
+                    ba = a;
+                    bj = j;
                 }
             }
         }
+        if (ba < 0) break;
 
-        if (best_in != -1 && best_out != -1)
+        if (!(ObjFunction.evaluate_exchange_cost(CL[ba], (*sol)[bj], *sol) < -eps))
         {
-            auto oit = find(sol->begin(), sol->end(), best_out);
-            if (oit != sol->end()) sol->erase(oit);
-            sol->add(best_in);
+            // accumulated rounding, or screened storage: rebuild the row, then block the pair
+            refresh(ba);
+            if (shared[ba] + loss[(size_t) ba * k + bj] < -eps)
+            {
+                loss[(size_t) ba * k + bj] = numeric_limits<double>::infinity();
+                blocked[ba] = 1;
+            }
+            continue;
+        }
 
-            CL.push_back(best_out);
-            auto cit = find(CL.begin(), CL.end(), best_in);
-            if (cit != CL.end()) 
-                CL.erase(cit);
+        const int p = CL[ba], q = (*sol)[bj];
+        (*sol)[bj] = p;
+        CL[ba] = q;
+        slot_of[q] = -1;
+        slot_of[p] = bj;
+        sol->cost = ObjFunction.evaluate(*sol);
 
-            double c = ObjFunction.evaluate(*sol);
-            sol->cost = c;
-            improved = true;
+        st = evaluator_.nearest_state(*sol);
+        changed.clear();
+        for (int i = 0; i < n; ++i)
+        {
+            int s = slot_of[st.near1[i]];
+            if (s != p_slot[i] || st.dist1[i] != p_d1[i] || st.dist2[i] != p_d2[i])
+                changed.push_back(i);
+        }
+
+        refresh(ba);
+        blocked[ba] = 0;
+        for (int a = 0; a < m; ++a)
+        {
+            if (a == ba) continue;
+            if (blocked[a])
+            {
+                refresh(a);
+                blocked[a] = 0;
+                continue;
+            }
+            const int c = CL[a];
+            double* row = &loss[(size_t) a * k];
+            double sh = shared[a];
+            for (int i : changed)
+            {
+                const double d = evaluator_.distance(c, i);
+                const double w = st.w[i] / st.total_w;
+                if (d < p_d1[i])
+                    sh -= w * (d - p_d1[i]);
+                else
+                    row[p_slot[i]] -= w * (min(d, p_d2[i]) - p_d1[i]);
+                if (d < st.dist1[i])
+                    sh += w * (d - st.dist1[i]);
+                else
+                    row[slot_of[st.near1[i]]] += w * (min(d, st.dist2[i]) - st.dist1[i]);
+            }
+            shared[a] = sh;
+        }
+
+        for (int i : changed)
+        {
+            p_slot[i] = slot_of[st.near1[i]];
+            p_d1[i] = st.dist1[i];
+            p_d2[i] = st.dist2[i];
         }
+
+        if (descentStep()) break;
     }
 
     return *sol;
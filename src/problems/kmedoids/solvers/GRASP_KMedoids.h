@@ -1,6 +1,7 @@
 #pragma once
 #include <algorithm>
 #include <limits>
+#include <memory>
 #include <random>
 #include <vector>
 
@@ -21,13 +22,111 @@ class GRASP_KMedoids : public AbstractGRASP<int>
     Solution<int> createEmptySol() override;
     Solution<int> localSearch() override;
     Solution<int> constructiveHeuristic() override;
+    // the Sampled policy stops short of a local optimum, so its results are not memoized
+    bool localSearchIsExact() const override { return ls_policy_ != LSPolicy::Sampled; }
+
+    // Sorted neighbor lists for next-nearest-medoid queries (see KMedoidsEvaluator).
+    virtual void useRankLists(shared_ptr<const NeighborIndex> ranks)
+    {
+        evaluator_.use_rank_lists(move(ranks));
+    }
+
+    // Computes distances from the features instead of D (see KMedoidsEvaluator).
+    void useFeatures(shared_ptr<const PointFeatures> features)
+    {
+        evaluator_.use_features(move(features));
+    }
+
+    // Float32 distance storage with double re-verification (see KMedoidsEvaluator).
+    void useFloat32(shared_ptr<const Float32Distances> dist32,
+                    shared_ptr<const PointFeatures> exact)
+    {
+        evaluator_.use_float32(move(dist32), move(exact));
+    }
+
+    // 16-bit quantized distance storage with exact re-checks (see KMedoidsEvaluator).
+    void useQuantized(shared_ptr<const Quantized16Distances> quant,
+                      shared_ptr<const PointFeatures> exact)
+    {
+        evaluator_.use_quantized(move(quant), move(exact));
+    }
+
+    // Shared pool for the constructive CL evaluation (see KMedoidsEvaluator::use_thread_pool).
+    void useThreadPool(shared_ptr<ThreadPool> pool, int min_chunk = 64)
+    {
+        evaluator_.use_thread_pool(move(pool), min_chunk);
+    }
+
+    // Per-point weights for the objective (see KMedoidsEvaluator::set_weights).
+    void setWeights(const vector<double>& w) { evaluator_.set_weights(w); }
+
+    // Swap descents of localSearch():
+    //  BestImproving - scans all (n-k) x k exchanges and applies the best, repeatedly.
+    //  EagerSwap     - FasterPAM: candidates are visited in a ring from a random start;
+    //                  each gets its best exchange against all medoids in one pass over
+    //                  the points (KMedoidsEvaluator::best_exchange), applied at once if
+    //                  improving. Ends after a full turn without a move, so the result
+    //                  is a local optimum of the swap neighborhood.
+    //  Sampled       - CLARANS: random (in, out) pairs, the first improving one is
+    //                  applied; ends after max_neighbor consecutive failures
+    //                  (<= 0: max(250, 1.25% of k(n-k)), as in CLARANS). Bounded
+    //                  latency, but not a guaranteed local optimum.
+    enum class LSPolicy
+    {
+        BestImproving,
+        EagerSwap,
+        Sampled
+    };
+
+    void setLocalSearchPolicy(LSPolicy policy, int max_neighbor = 0)
+    {
+        ls_policy_ = policy;
+        max_neighbor_ = max_neighbor;
+    }
+
+    // Two-stage exchange evaluation for BestImproving: each pass estimates every delta
+    // on a stratified sample of `batch` points (KMedoidsEvaluator::draw_sample); the
+    // moves whose confidence bound (estimate - 2 standard errors) is below zero are
+    // confirmed exactly in order of estimate, and the best of the first `confirm`
+    // (or, past those, the first) improving one is applied. A pass that confirms
+    // nothing falls back to an exact pass, so accepted moves are exact and the result
+    // is a local optimum. Used when n >= 4 * batch; batch <= 0 disables it.
+    void setScreening(int batch, int confirm = 8)
+    {
+        screen_batch_ = batch;
+        screen_confirm_ = max(1, confirm);
+    }
+
+    // Best-improvement engine for BestImproving without screening: every candidate's
+    // exchange costs are cached as a shared term plus one loss per medoid
+    // (KMedoidsEvaluator::exchange_losses). After a swap only the points whose
+    // nearest-medoid slot or nearest/second-nearest distance changed are revisited,
+    // removing their old contribution from every cached row and adding the new one,
+    // so a step costs O(changed points x candidates) instead of a full rescan. The
+    // chosen move is confirmed with evaluate_exchange_cost before it is applied. The
+    // incremental sums differ from a fresh scan in the last bits, so near-ties may
+    // resolve to a different move than the plain descent.
+    void setCachedGains(bool on) { cached_gains_ = on; }
+
+    KMedoidsEvaluator& evaluator() { return evaluator_; }
+    const KMedoidsEvaluator& evaluator() const { return evaluator_; }
+
     const int k_;
     mt19937& rng_ = AbstractGRASP<int>::rng;
 
    private:
-    const vector<vector<double>> D_;
-    const int n_;
-
     KMedoidsEvaluator evaluator_;
+    LSPolicy ls_policy_{LSPolicy::BestImproving};
+    int max_neighbor_{0};
+    int screen_batch_{0};
+    int screen_confirm_{8};
+    bool cached_gains_{false};
+
+    Solution<int> eagerLocalSearch();
+    Solution<int> sampledLocalSearch();
+    Solution<int> screenedLocalSearch();
+    Solution<int> cachedLocalSearch();
+    bool exactBestExchange(int& best_in, int& best_out);
+    void applyExchange(int elem_in, int elem_out);
 
 };
@@ -3,6 +3,112 @@
 #include <algorithm>
 
 Solution<int> GRASP_KMedoids_FI::localSearch()
+{
+    if (!rotating_scan_ && !dont_look_bits_ && !delta_ordering_) return restartingLocalSearch();
+
+    const double eps = 1e-12;
+
+    updateCL();
+    vector<int> ring = CL;
+    const int m = (int) ring.size();
+    const int k = (int) sol->size();
+    if (m == 0 || k == 0) return *sol;
+
+    const int n = ObjFunction.get_domain_size();
+    vector<char> dont_look(n, 0);
+    vector<double> last_delta(n, 0.0);
+    vector<int> slot_of(n, -1);
+    for (int s = 0; s < k; ++s) slot_of[(*sol)[s]] = s;
+
+    // slot s is checked against every candidate while visits - changed_at[s] < m
+    vector<long> changed_at(k, -(long) m);
+    long visits = 0;
+
+    uniform_int_distribution<int> start(0, m - 1);
+    int pos = start(rng_);
+    int idle = 0;
+    bool confirming = false;
+    vector<int> moved;
+
+    while (true)
+    {
+        if (idle >= m)
+        {
+            if (!dont_look_bits_ || !confirm_ || confirming) break;
+            fill(dont_look.begin(), dont_look.end(), 0);
+            confirming = true;
+            idle = 0;
+        }
+
+        // a re-sorted ring starts a new turn
+        if (pos == 0 && delta_ordering_)
+        {
+            stable_sort(ring.begin(), ring.end(),
+                        [&](int a, int b) { return last_delta[a] < last_delta[b]; });
+            idle = 0;
+        }
+
+        const int cin = ring[pos];
+        const bool full_scan = !dont_look[cin];
+        double best_dc = numeric_limits<double>::infinity();
+        int hit = -1;
+        for (int s = 0; s < k; ++s)
+        {
+            if (!full_scan && visits - changed_at[s] >= m) continue;
+            double dc = ObjFunction.evaluate_exchange_cost(cin, (*sol)[s], *sol);
+            best_dc = min(best_dc, dc);
+            if (dc < -eps)
+            {
+                hit = s;
+                break;
+            }
+        }
+        if (best_dc < numeric_limits<double>::infinity()) last_delta[cin] = best_dc;
+        ++visits;
+
+        if (hit < 0)
+        {
+            if (dont_look_bits_ && full_scan) dont_look[cin] = 1;
+            ++idle;
+            pos = (pos + 1 == m) ? 0 : pos + 1;
+            continue;
+        }
+
+        // cluster of the medoid taken out, before the swap
+        const int q = (*sol)[hit];
+        const vector<int>& before = evaluator().nearest_medoids(*sol);
+        moved.clear();
+        for (int i = 0; i < n; ++i)
+            if (before[i] == q) moved.push_back(i);
+
+        (*sol)[hit] = cin;
+        slot_of[q] = -1;
+        slot_of[cin] = hit;
+        ring[pos] = q;
+        last_delta[q] = 0.0;
+        sol->cost = ObjFunction.evaluate(*sol);
+
+        const vector<int>& after = evaluator().nearest_medoids(*sol);
+        changed_at[hit] = visits;
+        for (int i : moved)
+        {
+            dont_look[i] = 0;
+            changed_at[slot_of[after[i]]] = visits;
+        }
+        for (int i = 0; i < n; ++i)
+            if (after[i] == cin) dont_look[i] = 0;
+
+        idle = 0;
+        confirming = false;
+        pos = (pos + 1 == m) ? 0 : pos + 1;
+        if (descentStep()) break;
+    }
+
+    CL = ring;
+    return *sol;
+}
+
+Solution<int> GRASP_KMedoids_FI::restartingLocalSearch()
 {
     const double eps = 1e-12;
     bool improved = true;
@@ -46,7 +152,7 @@ Solution<int> GRASP_KMedoids_FI::localSearch()
 
             double c = ObjFunction.evaluate(*sol);
             sol->cost = c;
-            improved = true;
+            improved = !descentStep();
         }
     }
     return *sol;
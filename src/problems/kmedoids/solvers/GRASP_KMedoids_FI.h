@@ -3,6 +3,17 @@
 
 using namespace std;
 
+// First-improvement swap descent. By default every move restarts the scan at the
+// first candidate of the CL, trying each against every medoid in turn.
+//
+// Rotating scan: candidates are scanned in a ring starting at a random position,
+// and the scan continues after each accepted move instead of restarting. A candidate whose scan against every medoid found nothing gets a
+// don't-look bit and is skipped until a move changes a cluster near it: the points
+// of the removed and inserted medoids' clusters are reset. Medoids whose clusters
+// changed are checked against every candidate, bits or not, for one full turn of
+// the ring. The descent ends after a full turn without a move; bits may hide a few
+// improving pairs at that point, so an optional confirmation pass clears them and
+// scans on, making the result a local optimum of the full neighborhood.
 class GRASP_KMedoids_FI : public GRASP_KMedoids
 {
    public:
@@ -13,4 +24,29 @@ class GRASP_KMedoids_FI : public GRASP_KMedoids
     }
 
     Solution<int> localSearch() override;
+    // don't-look bits without the confirmation pass may stop short of a local optimum
+    bool localSearchIsExact() const override { return !dont_look_bits_ || confirm_; }
+
+    void setRotatingScan(bool on) { rotating_scan_ = on; }
+
+    // Rotating scan only (turning either on implies it). Off: every candidate is
+    // scanned on every turn (plain rotating first improvement, always a full local
+    // optimum).
+    void setDontLookBits(bool on, bool confirm = false)
+    {
+        dont_look_bits_ = on;
+        confirm_ = confirm;
+    }
+
+    // Re-sorts the ring by each candidate's last known best delta at the start of
+    // every turn, so the most promising candidates are tried first.
+    void setDeltaOrdering(bool on) { delta_ordering_ = on; }
+
+   private:
+    bool rotating_scan_{false};
+    bool dont_look_bits_{false};
+    bool confirm_{false};
+    bool delta_ordering_{false};
+
+    Solution<int> restartingLocalSearch();
 };
@@ -0,0 +1,95 @@
+#include "GRASP_KMedoids_GLS.h"
+
+#include <algorithm>
+
+GRASP_KMedoids_GLS::GRASP_KMedoids_GLS(double alpha, int iterations,
+                                       const vector<vector<double>>& D, int k, int L,
+                                       LSSearch mode, shared_ptr<const NeighborIndex> index)
+    : GRASP_KMedoids(alpha, iterations, D, k),
+      index_(index ? move(index) : make_shared<const NeighborIndex>(D, L)),
+      mode_(mode)
+{
+}
+
+bool GRASP_KMedoids_GLS::granularPass(int& best_in, int& best_out)
+{
+    const double eps = 1e-12;
+    double best_dc = 0.0;
+    best_in = best_out = -1;
+
+    vector<int> out_list(sol->begin(), sol->end());
+    for (int cout : out_list)
+    {
+        for (int cin : index_->neighbors(cout))
+        {
+            if (in_sol_[cin]) continue;
+
+            double dc = ObjFunction.evaluate_exchange_cost(cin, cout, *sol);
+            if (dc < best_dc - eps)
+            {
+                best_dc = dc;
+                best_in = cin;
+                best_out = cout;
+                if (mode_ == LSSearch::FirstImproving) return true;
+            }
+        }
+    }
+    return best_in != -1;
+}
+
+bool GRASP_KMedoids_GLS::fullPass(int& best_in, int& best_out)
+{
+    const double eps = 1e-12;
+    double best_dc = 0.0;
+    best_in = best_out = -1;
+
+    vector<int> out_list(sol->begin(), sol->end());
+    const int n = static_cast<int>(in_sol_.size());
+    for (int cin = 0; cin < n; ++cin)
+    {
+        if (in_sol_[cin]) continue;
+        for (int cout : out_list)
+        {
+            double dc = ObjFunction.evaluate_exchange_cost(cin, cout, *sol);
+            if (dc < best_dc - eps)
+            {
+                best_dc = dc;
+                best_in = cin;
+                best_out = cout;
+                if (mode_ == LSSearch::FirstImproving) return true;
+            }
+        }
+    }
+    return best_in != -1;
+}
+
+void GRASP_KMedoids_GLS::applySwap(int p_in, int p_out)
+{
+    auto oit = find(sol->begin(), sol->end(), p_out);
+    if (oit != sol->end()) sol->erase(oit);
+    sol->add(p_in);
+    in_sol_[p_out] = 0;
+    in_sol_[p_in] = 1;
+
+    CL.push_back(p_out);
+    auto cit = find(CL.begin(), CL.end(), p_in);
+    if (cit != CL.end()) CL.erase(cit);
+
+    sol->cost = ObjFunction.evaluate(*sol);
+}
+
+Solution<int> GRASP_KMedoids_GLS::localSearch()
+{
+    in_sol_.assign(index_->n(), 0);
+    for (int m : *sol) in_sol_[m] = 1;
+
+    int best_in = -1, best_out = -1;
+    while (true)
+    {
+        if (!granularPass(best_in, best_out) && !fullPass(best_in, best_out)) break;
+        applySwap(best_in, best_out);
+        if (descentStep()) break;
+    }
+
+    return *sol;
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <memory>
+
+#include "problems/kmedoids/NeighborIndex.h"
+#include "problems/kmedoids/solvers/GRASP_KMedoids.h"
+
+using namespace std;
+
+// GRASP with a granular swap neighborhood: a medoid is only exchanged with one of its
+// L nearest points. The full (n-k) x k neighborhood is scanned only when the granular
+// one has no improving move left.
+class GRASP_KMedoids_GLS : public GRASP_KMedoids
+{
+   public:
+    enum class LSSearch
+    {
+        BestImproving,
+        FirstImproving
+    };
+
+    GRASP_KMedoids_GLS(double alpha, int iterations, const vector<vector<double>>& D, int k, int L,
+                       LSSearch mode = LSSearch::BestImproving,
+                       shared_ptr<const NeighborIndex> index = nullptr);
+
+    Solution<int> localSearch() override;
+    bool localSearchIsExact() const override { return true; }
+
+    const NeighborIndex& neighborIndex() const { return *index_; }
+
+   private:
+    shared_ptr<const NeighborIndex> index_;
+    LSSearch mode_;
+    vector<char> in_sol_;
+
+    bool granularPass(int& best_in, int& best_out);
+    bool fullPass(int& best_in, int& best_out);
+    void applySwap(int p_in, int p_out);
+};
@@ -39,11 +39,10 @@ Solution<int> GRASP_KMedoids_POP::constructiveHeuristic()
         double max_dc = -numeric_limits<double>::infinity();
         vector<double> deltas(CL.size(), 0.0);
 
-        for (size_t i = 0; i < CL.size(); ++i)
+        // see GRASP_KMedoids::constructiveHeuristic: batched evaluation, reduction here
+        evaluator().evaluate_insertion_costs(CL.data(), (int) CL.size(), *sol, deltas.data());
+        for (double dc : deltas)
         {
-            int c = CL[i];
-            double dc = ObjFunction.evaluate_insertion_cost(c, *sol);
-            deltas[i] = dc;
             if (dc < min_dc) 
                 min_dc = dc;
             if (dc > max_dc) 
@@ -84,10 +83,58 @@ Solution<int> GRASP_KMedoids_POP::constructiveHeuristic()
 
         if (next_tr < triggers.size() && (int) sol->size() == triggers[next_tr])
         {
-            localSearch();
+            if (max_moves_ > 0)
+                milestoneLocalSearch();
+            else
+                localSearch();
             ++next_tr;
         }
     }
 
     return *sol;
 }
+
+// Candidates are scanned from a random offset, each against every medoid; the first
+// improving exchange is applied and the scan goes on with the next candidate. The
+// medoid taken out drops into the candidate's CL slot, so CL stays valid without a
+// rebuild. Stops at the move or evaluation budget, or after a full cycle over CL
+// without an improvement (a local optimum of the partial solution).
+void GRASP_KMedoids_POP::milestoneLocalSearch()
+{
+    const double eps = 1e-12;
+
+    updateCL();
+    const int m = (int) CL.size();
+    if (m == 0 || sol->empty())
+        return;
+
+    const long budget = (max_evals_ > 0) ? max_evals_ : (long) ObjFunction.get_domain_size();
+    uniform_int_distribution<int> start(0, m - 1);
+    int pos = start(rng_);
+    int moves = 0, idle = 0;
+    long evals = 0;
+
+    while (moves < max_moves_ && evals < budget && idle < m)
+    {
+        const int cin = CL[pos];
+        bool applied = false;
+        for (size_t s = 0; s < sol->size() && evals < budget; ++s)
+        {
+            const int cout = (*sol)[s];
+            ++evals;
+            if (ObjFunction.evaluate_exchange_cost(cin, cout, *sol) < -eps)
+            {
+                (*sol)[s] = cin;
+                CL[pos] = cout;
+                ++moves;
+                applied = true;
+                break;
+            }
+        }
+        idle = applied ? 0 : idle + 1;
+        pos = (pos + 1 == m) ? 0 : pos + 1;
+    }
+
+    if (moves > 0)
+        sol->cost = ObjFunction.evaluate(*sol);
+}
@@ -14,6 +14,23 @@ class GRASP_KMedoids_POP : public GRASP_KMedoids
 
     Solution<int> constructiveHeuristic() override;
 
+    // Bounded milestone search: instead of a full best-improvement descent on the
+    // partial solution, each milestone runs a first-improvement pass that applies at
+    // most max_moves exchanges and evaluates at most max_evals candidate pairs
+    // (max_evals <= 0: one pair per point, about the cost of one construction step).
+    // The evaluator's nearest-medoid cache follows the swaps incrementally, so the
+    // remaining construction steps start from it. max_moves <= 0 restores the full
+    // descent.
+    void setMilestoneBudget(int max_moves, long max_evals = 0)
+    {
+        max_moves_ = max_moves;
+        max_evals_ = max_evals;
+    }
+
    private:
     std::vector<double> milestones_;
+    int max_moves_{0};
+    long max_evals_{0};
+
+    void milestoneLocalSearch();
 };
@@ -1,8 +1,23 @@
 #include "GRASP_KMedoids_RPG.h"
 
 #include <algorithm>
+#include <cmath>
 #include <random>
 
+int GRASP_KMedoids_RPG::sampleSize() const
+{
+    if (p_ > 0) return p_;
+    double n = evaluator().get_domain_size();
+    double eps = min(max(epsilon_, 1e-12), 1.0 - 1e-12);
+    return max(1, static_cast<int>(ceil(n / max(1, k_local_) * log(1.0 / eps))));
+}
+
+// Best of a random sample per step (p candidates, or the stochastic-greedy size).
+// The unchosen candidates are the prefix [0, live) of an index pool. Each step draws
+// its sample by a partial Fisher-Yates shuffle of that prefix (the first s entries,
+// O(s)), evaluates the sample in one batched pass over the evaluator's cached nearest
+// distances (split over the evaluator's thread pool, if any) and swaps the winner
+// out of the prefix in O(1).
 Solution<int> GRASP_KMedoids_RPG::constructiveHeuristic()
 {
     CL = makeCL();
@@ -11,44 +26,29 @@ Solution<int> GRASP_KMedoids_RPG::constructiveHeuristic()
     cost = numeric_limits<double>::infinity();
 
     auto& rng = AbstractGRASP<int>::rng;
+    const int s_max = sampleSize();
+    vector<int>& pool = CL;
+    int live = static_cast<int>(pool.size());
+    vector<double> deltas(min(s_max, live));
 
-    while (static_cast<int>(sol->size()) < k_local_ && !CL.empty())
+    while (static_cast<int>(sol->size()) < k_local_ && live > 0)
     {
-        if (!sol->empty())
+        const int s = min(s_max, live);
+        for (int j = 0; j < s; ++j)
         {
-            const double c = ObjFunction.evaluate(*sol);
-            sol->cost = c;
-            cost = c;
+            uniform_int_distribution<int> dist(j, live - 1);
+            swap(pool[j], pool[dist(rng)]);
         }
 
-        updateCL();
-        if (CL.empty()) 
-            break;
+        evaluator().evaluate_insertion_costs(pool.data(), s, *sol, deltas.data());
+        int best = static_cast<int>(min_element(deltas.begin(), deltas.begin() + s) - deltas.begin());
 
-        const int m = min<int>(p_, static_cast<int>(CL.size()));
-        shuffle(CL.begin(), CL.end(), rng);
-        vector<int> sample(CL.begin(), CL.begin() + m);
-
-        int chosen = sample[0];
-        double best_dc = ObjFunction.evaluate_insertion_cost(chosen, *sol);
-        for (int i = 1; i < m; ++i)
-        {
-            int cnd = sample[i];
-            double dc = ObjFunction.evaluate_insertion_cost(cnd, *sol);
-            if (dc < best_dc)
-            {
-                best_dc = dc;
-                chosen = cnd;
-            }
-        }
-
-        auto it = find(CL.begin(), CL.end(), chosen);
-        if (it != CL.end()) 
-            CL.erase(it);
-
-        sol->add(chosen);
-        sol->cost = ObjFunction.evaluate(*sol);
-        RCL.clear();
+        sol->add(pool[best]);
+        swap(pool[best], pool[--live]);
     }
+
+    pool.resize(live);
+    sol->cost = ObjFunction.evaluate(*sol);
+    cost = sol->cost;
     return *sol;
 }
@@ -12,7 +12,18 @@ class GRASP_KMedoids_RPG : public GRASP_KMedoids
 
     Solution<int> constructiveHeuristic() override;
 
+    // Stochastic greedy (Mirzasoleiman et al., "Lazier than lazy greedy"): with p <= 0
+    // every step takes the best of a uniform sample of (n / k) ln(1 / epsilon)
+    // candidates. The cost reduction is monotone submodular, so the construction keeps
+    // a 1 - 1/e - epsilon approximation in expectation with O(n ln(1 / epsilon))
+    // insertion evaluations per solution, whatever k is.
+    void setStochasticGreedy(double epsilon) { epsilon_ = epsilon; }
+
+    // Candidates evaluated per construction step.
+    int sampleSize() const;
+
    private:
     int k_local_;
     int p_;
+    double epsilon_{0.01};
 };
@@ -4,6 +4,8 @@
 #include <limits>
 #include <unordered_set>
 
+#include "../MedoidScan.h"
+
 GRASP_KMedoids_WLS::GRASP_KMedoids_WLS(double alpha, int iterations, const vector<vector<double>>& D,
                                      int k, LSSearch mode)
     : GRASP_KMedoids(alpha, iterations, D, k),
@@ -17,19 +19,55 @@ GRASP_KMedoids_WLS::GRASP_KMedoids_WLS(double alpha, int iterations, const vecto
     vector<vector<tuple<int,double>>> summed_distances;
 }
 
+// Slot in S of the medoid nearest to the point whose distance row is `row` (first one
+// on ties); unrolled for small k, see MedoidScan.h.
+int GRASP_KMedoids_WLS::nearest_in(const double* row, const vector<int>& S) const
+{
+    const int* ms = S.data();
+    double d;
+    int s = nearest_slot(k_, [row, ms](int t) { return row[ms[t]]; }, d);
+    return s < 0 ? 0 : s;
+}
+
 void GRASP_KMedoids_WLS::buildAssignments(const vector<int>& S)
 {
     assignments.resize(n_);
+
+    // with rank lists the nearest medoid is the first marked entry of u's sorted list;
+    // entries at equal distance are contiguous there, so the run of ties after it is
+    // checked for a lower slot of S, which is the one nearest_in picks
+    if (ranks_)
+    {
+        slot_of_.assign(n_, -1);
+        for (int i = k_ - 1; i >= 0; --i) slot_of_[S[i]] = i;
+    }
+
     for (int u = 0; u < n_; ++u)
     {
-        for (int i = 0; i < k_; ++i)
+        if (ranks_)
         {
-            int f = S[i];
-            if (i == 0 || D_[u][f] < D_[u][assignments[u]])
+            const auto& list = ranks_->neighbors(u);
+            const double* row = D_[u].data();
+            int best = slot_of_[u];  // the list leaves out u, a medoid at distance 0
+            size_t r = 0;
+            for (; best == -1 && r < list.size(); ++r) best = slot_of_[list[r]];
+            if (best != -1)
             {
-                assignments[u] = f;
+                double d = row[S[best]];
+                for (; r < list.size() && row[list[r]] == d; ++r)
+                {
+                    if (slot_of_[list[r]] != -1) best = min(best, slot_of_[list[r]]);
+                }
+                // a run of ties cut off by a truncated list falls back to the scan
+                if (r < list.size())
+                {
+                    assignments[u] = S[best];
+                    continue;
+                }
             }
         }
+
+        assignments[u] = S[nearest_in(D_[u].data(), S)];
     }
 }
 
@@ -78,12 +116,10 @@ void GRASP_KMedoids_WLS::iterateConvergence(vector<int>& S)
 
     for (int u = 0; u < n_; u++){
         int medoid = assignments[u];
-        for(int i = 0; i < k_; i++){
-            int f = S[i];
-            if (D_[u][f] < D_[u][medoid]){
-                medoid = f;
-                changed = true;
-            }
+        int f = S[nearest_in(D_[u].data(), S)];
+        if (D_[u][f] < D_[u][medoid]){
+            medoid = f;
+            changed = true;
         }
         updateSummedDistances_swappoint(u, medoid, S);
         assignments[u] = medoid;
@@ -113,7 +149,8 @@ void GRASP_KMedoids_WLS::iterateConvergence(vector<int>& S)
         }
     }
 
-    if (changed)
+    // each medoid update is one move of the descent (truncation, memo)
+    if (changed && !descentStep())
         iterateConvergence(S);
 }
 
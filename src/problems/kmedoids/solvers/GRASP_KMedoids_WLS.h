@@ -16,16 +16,25 @@ class GRASP_KMedoids_WLS : public GRASP_KMedoids
                       LSSearch mode = LSSearch::BestImproving);
 
     Solution<int> localSearch() override;
+    bool localSearchIsExact() const override { return true; }
+
+    void useRankLists(shared_ptr<const NeighborIndex> ranks) override
+    {
+        ranks_ = ranks;
+        GRASP_KMedoids::useRankLists(move(ranks));
+    }
 
    private:
     const vector<vector<double>>& D_;
     int n_, m_, k_;
     LSSearch mode_;
-
+    shared_ptr<const NeighborIndex> ranks_;
+    vector<int> slot_of_;  // medoid -> first slot in S, -1 for other points
 
     vector<int> assignments;
     vector<double> summed_distances;
 
+    int nearest_in(const double* row, const vector<int>& S) const;
     void buildAssignments(const vector<int>& S);
     void buildSummedDistances(const vector<int>& S);
 
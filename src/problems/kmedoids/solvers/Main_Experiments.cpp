@@ -5,6 +5,7 @@
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <memory>
 #include <numeric>
 #include <random>
 #include <sstream>
@@ -17,11 +18,14 @@
 
 #include "metaheuristics/grasp/AbstractGRASP.h"
 #include "problems/kmedoids/common.h"
+#include "problems/kmedoids/solvers/CLARA_KMedoids.h"
 #include "problems/kmedoids/solvers/GRASP_KMedoids.h"
 #include "problems/kmedoids/solvers/GRASP_KMedoids_FI.h"
+#include "problems/kmedoids/solvers/GRASP_KMedoids_GLS.h"
 #include "problems/kmedoids/solvers/GRASP_KMedoids_POP.h"
 #include "problems/kmedoids/solvers/GRASP_KMedoids_RPG.h"
 #include "problems/kmedoids/solvers/GRASP_KMedoids_WLS.h"
+#include "problems/kmedoids/solvers/Multilevel_KMedoids.h"
 
 using namespace std;
 
@@ -93,11 +97,132 @@ vector<string> INSTANCE_FILES = {"2-FACE.i",
 
 bool USE_ZSCORE = true;
 
+// Dissimilarity of the distance matrix and of every on-the-fly distance path
+// (Euclidean, SqEuclidean, Manhattan, Chebyshev, Cosine; see Metrics.h). Triangle
+// pruning is turned off for the non-metrics (SqEuclidean, Cosine), and the ILP
+// targets are only used for Euclidean.
+Metric METRIC = Metric::Euclidean;
+
 vector<int> K_VALUES = {3, 4, 5, 6, 20, 25};
 
 vector<double> ALPHA_VALUES = {0.05};
 vector<int> P_VALUES = {20};
 
+// Stochastic-greedy construction (RPG with a sample of (n / k) ln(1 / eps) candidates
+// per step instead of a fixed p); one configuration per epsilon.
+vector<double> SG_EPSILONS = {0.01};
+
+bool USE_TRIANGLE_PRUNING = true;
+
+// Distances computed from the z-scored features instead of the n x n matrix:
+// -1 = automatic (d <= FEATURE_SPACE_MAX_D and n >= FEATURE_SPACE_MIN_N), 0 = never,
+// 1 = always. Below that size the matrix is built quickly and its reads are cheaper
+// than recomputing distances. Solvers that read D directly (WLS, GLS, multilevel)
+// keep the matrix.
+int FEATURE_SPACE = -1;
+int FEATURE_SPACE_MAX_D = 8;
+int FEATURE_SPACE_MIN_N = 15000;
+
+// Float32 distance matrix built from the features (no double matrix), with reported
+// costs and improving moves re-verified in double. Same solver restriction as above.
+bool USE_FLOAT32_DISTANCES = false;
+
+// 16-bit quantized distance matrix (per-row scale, 4x smaller than doubles); moves
+// within the quantization error bound are re-checked exactly. Takes precedence over
+// float32.
+bool USE_QUANTIZED_DISTANCES = false;
+
+// CLARA: CLARA_SAMPLES subsamples of CLARA_SAMPLE_SIZE points (0 = 40 + 2k), each
+// solved with CLARA_INNER and a share of the time limit.
+int CLARA_SAMPLE_SIZE = 0;
+int CLARA_SAMPLES = 5;
+
+// Multilevel: coarsen down to ML_COARSE_SIZE points (0 = max(100, 10k)) by matching
+// over ML_MATCH_L nearest neighbors, solve that level with ML_INNER (ML_COARSE_SHARE
+// of the time limit; WLS and RW_BI, whose descent ignores point weights, run as
+// Standard), refine every finer level with at most ML_LEVEL_PASSES moves
+// over the ML_CANDIDATES nearest points of each medoid, then ML_FINAL_PASSES passes
+// of the full swap neighborhood. Refinement stops at the time limit.
+int ML_COARSE_SIZE = 0;
+int ML_CANDIDATES = 10;
+int ML_FINAL_PASSES = 2;
+int ML_LEVEL_PASSES = 10;
+int ML_MATCH_L = 10;
+double ML_COARSE_SHARE = 0.5;
+
+bool USE_PATH_RELINKING = false;
+int ELITE_POOL_SIZE = 10;
+PRMode PR_MODE = PRMode::Mixed;
+
+vector<double> REACTIVE_ALPHAS = {0.05, 0.10, 0.15, 0.20, 0.25, 0.30, 0.40, 0.50};
+int REACTIVE_BLOCK = 50;
+
+int GRANULAR_L = 10;
+
+// Swap descent (GRASP_KMedoids::LSPolicy) of the variants without a local search of
+// their own: BestImproving, EagerSwap (FasterPAM) or Sampled (CLARANS, ends after
+// CLARANS_MAX_NEIGHBOR consecutive failed samples; 0: the CLARANS default). ls_mode
+// is BEST_IMPROVING, EAGER_SWAP or SAMPLED_SWAP accordingly.
+using LSPolicy = GRASP_KMedoids::LSPolicy;
+LSPolicy LS_POLICY = LSPolicy::BestImproving;
+int CLARANS_MAX_NEIGHBOR = 0;
+
+// Mini-batch screening for the BestImproving descent (GRASP_KMedoids::setScreening):
+// deltas estimated on SCREEN_BATCH stratified points, the SCREEN_CONFIRM best
+// recomputed exactly. Only used when n >= 4 * SCREEN_BATCH; 0 disables it. Reported
+// as "+SCREEN" in ls_mode.
+int SCREEN_BATCH = 0;
+int SCREEN_CONFIRM = 8;
+
+// Cached exchange costs with incremental updates for the BestImproving descent when
+// screening is not used (GRASP_KMedoids::setCachedGains): cheaper steps, but ties and
+// rounding can pick a different best move. Reported as "+CACHED" in ls_mode.
+bool USE_CACHED_GAINS = false;
+
+// Threads evaluating the CL in the constructives (one pool shared by every solver,
+// see KMedoidsEvaluator::use_thread_pool); 1 keeps it on the calling thread, 0 uses
+// every core. Deltas, thresholds and RCL draws do not depend on it (so rows carry no
+// label for it).
+int CONSTRUCT_THREADS = 1;
+
+// First-improvement engine of GRASP_FI (GRASP_KMedoids_FI): the original restarting
+// scan, or the rotating scan ("+ROT") with optional don't-look bits ("+DLB", with an
+// optional confirmation pass that makes the result a full local optimum) and
+// re-sorting candidates by their last delta each turn ("+ORDERED"). Bits and
+// ordering imply the rotating scan.
+bool FI_ROTATING_SCAN = false;
+bool FI_DONT_LOOK_BITS = false;
+bool FI_DLB_CONFIRM = false;
+bool FI_DELTA_ORDERING = false;
+
+// Local-optimum memo (AbstractGRASP::enableLocalOptimumCache): local searches whose
+// starting medoid set was already descended from are replaced by the cached optimum.
+// Entries kept per run; 0 disables it. Reported as "+MEMO" in ls_mode.
+size_t LS_CACHE_SIZE = 0;
+
+// Lower-bound filter (AbstractGRASP::setLocalSearchFilter): constructions whose
+// predicted local optimum is more than LS_FILTER_MARGIN above the best get at most
+// LS_FILTER_TRUNCATED_MOVES moves instead of a full local search. Negative margin
+// disables it. Counts go to the ls_passed / ls_skipped CSV columns; reported as
+// "+FILTER" in ls_mode.
+double LS_FILTER_MARGIN = -1.0;
+int LS_FILTER_TRUNCATED_MOVES = 0;
+
+// Bounded milestone search for POP (GRASP_KMedoids_POP::setMilestoneBudget): at most
+// this many first-improvement exchanges per milestone, and at most
+// POP_MILESTONE_MAX_EVALS pair evaluations (0: one per point). 0 moves keeps the full
+// best-improvement descent. Reported as "+BOUNDED" in construct_mode.
+int POP_MILESTONE_MAX_MOVES = 0;
+long POP_MILESTONE_MAX_EVALS = 0;
+
+// Sorted neighbor lists for the evaluators (full up to RANK_FULL_MAX_N points,
+// truncated to RANK_TRUNCATED_L entries above that). Only pays off for larger k.
+// Exact (same moves and tie-breaks as the panel scan), so rows carry no label for it.
+bool USE_RANK_LISTS = false;
+int RANK_LISTS_MIN_K = 8;
+int RANK_FULL_MAX_N = 2000;
+int RANK_TRUNCATED_L = 64;
+
 long MAX_TIME_MILLIS = 15L * 60L * 1000L;
 int MAX_TOTAL_ITERATIONS = 10000;
 
@@ -168,7 +293,9 @@ vector<string> ALLOW_INSTANCES = {
 vector<int> ALLOW_KS = {3, 4, 5, 6, 20, 25};
 
 vector<string> ALLOW_CONFIG_PREFIX = {
-    "GRASP_alpha=", "GRASP_FI_alpha=", "GRASP_POP_alpha=", "RPG_p=", "GRASP_WLS_alpha="};
+    "GRASP_alpha=", "GRASP_FI_alpha=", "GRASP_POP_alpha=", "RPG_p=", "SG_eps=", "GRASP_WLS_alpha=",
+    "GRASP_REACTIVE_block=", "GRASP_GLS_alpha=", "GRASP_GLS_FI_alpha=", "CLARA_alpha=",
+    "ML_alpha="};
 
 vector<string> BLOCK_CONFIG_PREFIX = {};
 
@@ -697,15 +824,24 @@ enum class SolverKind
     StandardFI,
     POP,
     RW_BI,
-    WLS
+    WLS,
+    Reactive,
+    GLS,
+    GLS_FI,
+    CLARA,
+    Multilevel
 };
 
+SolverKind CLARA_INNER = SolverKind::Standard;
+SolverKind ML_INNER = SolverKind::Standard;
+
 struct ExperimentConfig
 {
     string name;
     SolverKind kind;
     double alpha;
     int p;
+    double epsilon{-1.0};  // RPG with p <= 0: stochastic-greedy epsilon
 };
 
 struct ExperimentResult
@@ -728,6 +864,8 @@ struct ExperimentResult
     bool feasible{};
     double time_s{};
     double time_to_solution_s{};
+    long ls_passed{};
+    long ls_skipped{};
     string elements;
 };
 
@@ -763,8 +901,7 @@ class GRASP_KMedoids_WithStopping : public GRASP_KMedoids
                 break;
             }
 
-            constructiveHeuristic();
-            localSearch();
+            iterate();
 
             if (bestSol->cost > sol->cost)
             {
@@ -839,6 +976,9 @@ class GRASP_KMedoids_FI_WithStopping : public GRASP_KMedoids_FI
           target_avg_value_(target_avg_value),
           ttt_mode_(ttt_mode)
     {
+        setRotatingScan(FI_ROTATING_SCAN);
+        setDontLookBits(FI_DONT_LOOK_BITS, FI_DLB_CONFIRM);
+        setDeltaOrdering(FI_DELTA_ORDERING);
     }
 
     Solution<int> solve()
@@ -860,8 +1000,7 @@ class GRASP_KMedoids_FI_WithStopping : public GRASP_KMedoids_FI
                 break;
             }
 
-            constructiveHeuristic();
-            localSearch();
+            iterate();
 
             if (bestSol->cost > sol->cost)
             {
@@ -957,8 +1096,7 @@ class GRASP_KMedoids_RPG_WithStopping : public GRASP_KMedoids_RPG
                 break;
             }
 
-            constructiveHeuristic();
-            localSearch();
+            iterate();
 
             if (bestSol->cost > sol->cost)
             {
@@ -1033,6 +1171,7 @@ class GRASP_KMedoids_POP_WithStopping : public GRASP_KMedoids_POP
           target_avg_value_(target_avg_value),
           ttt_mode_(ttt_mode)
     {
+        setMilestoneBudget(POP_MILESTONE_MAX_MOVES, POP_MILESTONE_MAX_EVALS);
     }
 
     Solution<int> solve()
@@ -1054,8 +1193,7 @@ class GRASP_KMedoids_POP_WithStopping : public GRASP_KMedoids_POP
                 break;
             }
 
-            constructiveHeuristic();
-            localSearch();
+            iterate();
 
             if (bestSol->cost > sol->cost)
             {
@@ -1148,8 +1286,102 @@ class GRASP_KMedoids_WLS_WithStopping : public GRASP_KMedoids_WLS
                 break;
             }
 
-            constructiveHeuristic();
-            localSearch();
+            iterate();
+
+            if (bestSol->cost > sol->cost)
+            {
+                bestSol = sol;
+                iterations_to_best = i;
+                last_improve_iter = i;
+                no_improve_streak = 0;
+                ms = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - t0)
+                         .count();
+                time_to_solution_ms = ms;  // atualizar sempre que melhorar
+            }
+            else
+            {
+                if (last_improve_iter >= 0)
+                    no_improve_streak = i - last_improve_iter;
+            }
+
+            if (PRINT_ITER)
+            {
+                double elapsed_s = ms / 1000.0;
+                double curr = sol->cost;
+                double best = (i == 0 ? curr : bestSol->cost);
+                cout << "      [it " << i << "] avg=" << fixed << setprecision(9) << curr
+                     << " | best=" << best << " | streak=" << no_improve_streak
+                     << " | t=" << setprecision(3) << elapsed_s << "s\n";
+            }
+
+            if (MAX_NO_IMPROVEMENT_ITERS > 0 && last_improve_iter >= 0 &&
+                no_improve_streak >= MAX_NO_IMPROVEMENT_ITERS)
+            {
+                stopped_by_patience = true;
+                break;
+            }
+
+            if (reached_target_4dec(bestSol->cost, target_avg_value_))
+            {
+                if (time_to_target_ms < 0) time_to_target_ms = (long) ms;
+                break;
+            }
+
+            ++i;
+        }
+        total_iterations = i;
+        auto tf = chrono::steady_clock::now();
+        execution_time_ms = (long) chrono::duration_cast<chrono::milliseconds>(tf - t0).count();
+        return *bestSol;
+    }
+
+    int total_iterations{0}, iterations_to_best{0};
+    long execution_time_ms{0};
+    bool stopped_by_time{false};
+    bool stopped_by_patience{false};
+    long time_to_target_ms{-1};
+    long time_to_solution_ms{-1};
+
+   private:
+    long max_time_ms_;
+    double target_avg_value_;
+    bool ttt_mode_;
+};
+
+class GRASP_KMedoids_GLS_WithStopping : public GRASP_KMedoids_GLS
+{
+   public:
+    GRASP_KMedoids_GLS_WithStopping(double alpha, int iterations, vector<vector<double>>& D, int k,
+                                    LSSearch mode, shared_ptr<const NeighborIndex> index,
+                                    long max_time_ms, double target_avg_value = -1.0,
+                                    bool ttt_mode = false)
+        : GRASP_KMedoids_GLS(alpha, iterations, D, k, index->L(), mode, index),
+          max_time_ms_(max_time_ms),
+          target_avg_value_(target_avg_value),
+          ttt_mode_(ttt_mode)
+    {
+    }
+
+    Solution<int> solve()
+    {
+        bestSol = createEmptySol();
+        auto t0 = chrono::steady_clock::now();
+        int i = 0;
+
+        int last_improve_iter = -1;
+        int no_improve_streak = 0;
+
+        while (i < iterations)
+        {
+            auto now = chrono::steady_clock::now();
+            auto ms = chrono::duration_cast<chrono::milliseconds>(now - t0).count();
+            if (ms > max_time_ms_)
+            {
+                stopped_by_time = true;
+                break;
+            }
+
+            iterate();
 
             if (bestSol->cost > sol->cost)
             {
@@ -1231,20 +1463,56 @@ vector<ExperimentConfig> generate_configurations()
     for (int p : P_VALUES)
         cfgs.push_back(ExperimentConfig{"RPG_p=" + to_string(p), SolverKind::RPG, -1.0, p});
 
+    for (double e : SG_EPSILONS)
+        cfgs.push_back(ExperimentConfig{"SG_eps=" + to_string(e), SolverKind::RPG, -1.0, 0, e});
+
     for (double a : ALPHA_VALUES)
         cfgs.push_back(ExperimentConfig{"GRASP_POP_alpha=" + to_string(a), SolverKind::POP, a, -1});
 
     for (double a : ALPHA_VALUES)
         cfgs.push_back(ExperimentConfig{"GRASP_WLS_alpha=" + to_string(a), SolverKind::WLS, a, -1});
 
+    for (double a : ALPHA_VALUES)
+        cfgs.push_back(ExperimentConfig{"GRASP_GLS_alpha=" + to_string(a), SolverKind::GLS, a, -1});
+
+    for (double a : ALPHA_VALUES)
+        cfgs.push_back(
+            ExperimentConfig{"GRASP_GLS_FI_alpha=" + to_string(a), SolverKind::GLS_FI, a, -1});
+
+    if (!REACTIVE_ALPHAS.empty())
+        cfgs.push_back(ExperimentConfig{"GRASP_REACTIVE_block=" + to_string(REACTIVE_BLOCK),
+                                        SolverKind::Reactive, -1.0, -1});
+
+    for (double a : ALPHA_VALUES)
+        cfgs.push_back(ExperimentConfig{"CLARA_alpha=" + to_string(a) + "_m=" + to_string(CLARA_SAMPLES),
+                                        SolverKind::CLARA, a, P_VALUES.empty() ? 20 : P_VALUES.front()});
+
+    for (double a : ALPHA_VALUES)
+        cfgs.push_back(ExperimentConfig{"ML_alpha=" + to_string(a), SolverKind::Multilevel, a,
+                                        P_VALUES.empty() ? 20 : P_VALUES.front()});
+
     return cfgs;
 }
 
-vector<vector<double>> load_distance_matrix(string& instance_path)
+vector<vector<double>> load_features(string& instance_path)
 {
     auto X = load_i_dataset(instance_path, ';', ',');
     if (USE_ZSCORE) zscore_inplace(X, 1);
-    return pairwise_euclidean(X);
+    return X;
+}
+
+// Solvers that index the double distance matrix themselves.
+bool reads_distance_matrix(SolverKind kind)
+{
+    return kind == SolverKind::WLS || kind == SolverKind::RW_BI || kind == SolverKind::GLS ||
+           kind == SolverKind::GLS_FI || kind == SolverKind::Multilevel;
+}
+
+bool use_feature_space(SolverKind kind, int n, int d)
+{
+    if (reads_distance_matrix(kind)) return false;
+    if (FEATURE_SPACE >= 0) return FEATURE_SPACE == 1;
+    return d <= FEATURE_SPACE_MAX_D && n >= FEATURE_SPACE_MIN_N;
 }
 
 void save_ttt_header_if_needed(string& csv_path)
@@ -1267,17 +1535,338 @@ void append_ttt_line(string& csv_path, string& instance_file, int k, string& con
       << '\n';
 }
 
+// Distance storage of one run; all empty means the dense double matrix. With a
+// compact matrix, features is the exact source used for re-verification.
+struct DistanceBackend
+{
+    shared_ptr<const PointFeatures> features;
+    shared_ptr<const Float32Distances> dist32;
+    shared_ptr<const Quantized16Distances> quant;
+};
+
+// Optional evaluator structures and post-local-search stages shared by every GRASP variant.
+template <typename G>
+void configure_grasp(G& grasp, const shared_ptr<const NeighborIndex>& ranks,
+                     const DistanceBackend& backend = {})
+{
+    if (backend.quant)
+        grasp.useQuantized(backend.quant, backend.features);
+    else if (backend.dist32)
+        grasp.useFloat32(backend.dist32, backend.features);
+    else if (backend.features)
+        grasp.useFeatures(backend.features);
+    if (ranks) grasp.useRankLists(ranks);
+    if (CONSTRUCT_THREADS != 1) grasp.useThreadPool(ThreadPool::shared(CONSTRUCT_THREADS));
+    grasp.setLocalSearchPolicy(LS_POLICY, CLARANS_MAX_NEIGHBOR);
+    grasp.setScreening(SCREEN_BATCH, SCREEN_CONFIRM);
+    grasp.setCachedGains(USE_CACHED_GAINS);
+    if (LS_CACHE_SIZE > 0) grasp.enableLocalOptimumCache(LS_CACHE_SIZE);
+    if (LS_FILTER_MARGIN >= 0.0)
+        grasp.setLocalSearchFilter(LS_FILTER_MARGIN, LS_FILTER_TRUNCATED_MOVES);
+    grasp.evaluator().set_triangle_pruning(USE_TRIANGLE_PRUNING && is_metric(METRIC));
+    if (USE_PATH_RELINKING) grasp.enablePathRelinking(ELITE_POOL_SIZE, PR_MODE);
+}
+
+string construct_suffix(SolverKind kind)
+{
+    return (kind == SolverKind::POP && POP_MILESTONE_MAX_MOVES > 0) ? "+BOUNDED" : "";
+}
+
+// ls_mode of the variants without a local search of their own
+string default_ls_mode(SolverKind kind)
+{
+    if (kind == SolverKind::WLS) return "BEST_IMPROVING";
+    return LS_POLICY == LSPolicy::EagerSwap ? "EAGER_SWAP"
+         : LS_POLICY == LSPolicy::Sampled   ? "SAMPLED_SWAP"
+                                            : "BEST_IMPROVING";
+}
+
+string ls_suffix(SolverKind kind)
+{
+    string suffix;
+    if (kind == SolverKind::StandardFI)
+    {
+        bool rotating = FI_ROTATING_SCAN || FI_DONT_LOOK_BITS || FI_DELTA_ORDERING;
+        if (rotating) suffix += "+ROT";
+        if (FI_DONT_LOOK_BITS) suffix += "+DLB";
+        if (FI_DELTA_ORDERING) suffix += "+ORDERED";
+    }
+    // descents that may stop short of a local optimum bypass the memo
+    bool own_ls = kind == SolverKind::StandardFI || kind == SolverKind::WLS ||
+                  kind == SolverKind::RW_BI || kind == SolverKind::GLS || kind == SolverKind::GLS_FI;
+    bool exact = (kind == SolverKind::StandardFI) ? (!FI_DONT_LOOK_BITS || FI_DLB_CONFIRM)
+                                                  : (own_ls || LS_POLICY != LSPolicy::Sampled);
+    if (!own_ls && LS_POLICY == LSPolicy::BestImproving)
+    {
+        if (SCREEN_BATCH > 0) suffix += "+SCREEN";
+        if (USE_CACHED_GAINS) suffix += "+CACHED";
+    }
+    if (LS_CACHE_SIZE > 0 && exact) suffix += "+MEMO";
+    if (LS_FILTER_MARGIN >= 0.0) suffix += "+FILTER";
+    return suffix;
+}
+
+string post_ls_suffix()
+{
+    if (!USE_PATH_RELINKING) return "";
+    return PR_MODE == PRMode::Forward ? "+PR_FORWARD"
+         : PR_MODE == PRMode::Backward ? "+PR_BACKWARD"
+                                       : "+PR_MIXED";
+}
+
+// Full ls_mode column of a GRASP variant (also the inner solver of CLARA/multilevel).
+string ls_mode_label(SolverKind kind)
+{
+    string base = (kind == SolverKind::StandardFI) ? "FIRST_IMPROVING"
+                : (kind == SolverKind::RW_BI)      ? "FAST_INTERCHANGE_BI"
+                : (kind == SolverKind::GLS)        ? "GRANULAR_BI"
+                : (kind == SolverKind::GLS_FI)     ? "GRANULAR_FI"
+                                                   : default_ls_mode(kind);
+    return base + ls_suffix(kind) + post_ls_suffix();
+}
+
+// "alpha:prob" pairs with the probabilities reached at the end of the run.
+string format_reactive_alphas(const vector<double>& alphas, const vector<double>& probs)
+{
+    ostringstream os;
+    os.setf(ios::fixed);
+    for (size_t i = 0; i < alphas.size(); ++i)
+    {
+        if (i) os << ' ';
+        os << setprecision(2) << alphas[i];
+        if (i < probs.size()) os << ':' << setprecision(3) << probs[i];
+    }
+    return os.str();
+}
+
+template <typename G>
+void configure_subsample(G& grasp, const vector<double>& weights)
+{
+    configure_grasp(grasp, nullptr);
+    if (!weights.empty()) grasp.setWeights(weights);
+}
+
+// Runs one GRASP variant (without target) on a reduced distance matrix: a CLARA
+// subsample or the coarsest multilevel point set (weighted).
+Solution<int> solve_subsample(SolverKind kind, double alpha, int p, vector<vector<double>>& Ds,
+                              int k, long budget_ms, const vector<double>& weights = {})
+{
+    if (kind == SolverKind::StandardFI)
+    {
+        GRASP_KMedoids_FI_WithStopping grasp(alpha, MAX_TOTAL_ITERATIONS, Ds, k, budget_ms);
+        configure_subsample(grasp, weights);
+        return grasp.solve();
+    }
+    if (kind == SolverKind::POP)
+    {
+        GRASP_KMedoids_POP_WithStopping grasp(alpha, MAX_TOTAL_ITERATIONS, Ds, k, budget_ms);
+        configure_subsample(grasp, weights);
+        return grasp.solve();
+    }
+    if (kind == SolverKind::RPG)
+    {
+        GRASP_KMedoids_RPG_WithStopping grasp(0.0, MAX_TOTAL_ITERATIONS, Ds, k, p, budget_ms);
+        configure_subsample(grasp, weights);
+        return grasp.solve();
+    }
+    if (kind == SolverKind::WLS || kind == SolverKind::RW_BI)
+    {
+        GRASP_KMedoids_WLS_WithStopping grasp(alpha, MAX_TOTAL_ITERATIONS, Ds, k, budget_ms);
+        configure_subsample(grasp, weights);
+        return grasp.solve();
+    }
+    if (kind == SolverKind::GLS || kind == SolverKind::GLS_FI)
+    {
+        auto mode = (kind == SolverKind::GLS_FI) ? GRASP_KMedoids_GLS::LSSearch::FirstImproving
+                                                 : GRASP_KMedoids_GLS::LSSearch::BestImproving;
+        GRASP_KMedoids_GLS_WithStopping grasp(alpha, MAX_TOTAL_ITERATIONS, Ds, k, mode,
+                                              make_shared<const NeighborIndex>(Ds, GRANULAR_L),
+                                              budget_ms);
+        configure_subsample(grasp, weights);
+        return grasp.solve();
+    }
+
+    GRASP_KMedoids_WithStopping grasp(alpha, MAX_TOTAL_ITERATIONS, Ds, k, budget_ms);
+    if (kind == SolverKind::Reactive) grasp.setReactive(REACTIVE_ALPHAS, REACTIVE_BLOCK);
+    configure_subsample(grasp, weights);
+    return grasp.solve();
+}
+
+// CLARA never builds the n x n matrix: only the features are loaded.
+ExperimentResult run_clara_experiment(ExperimentConfig& config, string& instance_file, int k,
+                                      string& ttt_csv, double ilp_target)
+{
+    string instance_path = INSTANCES_DIR + "/" + instance_file;
+    auto X = load_features(instance_path);
+    int n = static_cast<int>(X.size());
+
+    auto make_clara = [&](double target)
+    {
+        long budget_ms = max(1L, MAX_TIME_MILLIS / max(1, CLARA_SAMPLES));
+        auto inner = [&config, budget_ms](vector<vector<double>>& Ds, int kk)
+        { return solve_subsample(CLARA_INNER, config.alpha, config.p, Ds, kk, budget_ms); };
+
+        CLARA_KMedoids::TargetCheck check = nullptr;
+        if (target > 0.0) check = [target](double c) { return reached_target_4dec(c, target); };
+
+        return CLARA_KMedoids(X, k, CLARA_SAMPLE_SIZE, CLARA_SAMPLES, inner, check, METRIC);
+    };
+
+    ExperimentResult r{};
+    r.config = config.name;
+    r.file = instance_file;
+    r.n = n;
+    r.k = k;
+    r.alpha = config.alpha;
+    r.construct_mode = "CLARA";
+    r.ls_mode = ls_mode_label(CLARA_INNER);
+    r.iterations = MAX_TOTAL_ITERATIONS;
+    r.feasible = true;
+
+    if (ENABLE_TTT_MODE)
+    {
+        double target_avg = (ilp_target > 0.0) ? ilp_target : get_target_avg_for(instance_file, k);
+        save_ttt_header_if_needed(ttt_csv);
+
+        MAX_TIME_MILLIS = 30 * 1000;
+
+        for (int run = 0; run < TTT_RUNS; ++run)
+        {
+            AbstractGRASP<int>::set_seed(run);
+            auto clara = make_clara(target_avg);
+            clara.solve();
+            r.sample_size = to_string(clara.sample_size());
+            append_ttt_line(ttt_csv, instance_file, k, config.name, target_avg, run,
+                            clara.time_to_target_ms);
+        }
+        r.time_limit_s = static_cast<double>(MAX_TIME_MILLIS) / 1000.0;
+        return r;
+    }
+
+    auto clara = make_clara(ilp_target);
+    auto sol = clara.solve();
+    double time_sec = static_cast<double>(clara.execution_time_ms) / 1000.0;
+
+    cout << "    -> Total: " << fixed << setprecision(6) << sol.cost * n << " | Avg: " << sol.cost
+         << ", Samples: " << clara.samples_run << " x " << clara.sample_size()
+         << ", Time: " << setprecision(3) << time_sec << "s\n";
+
+    ostringstream els;
+    for (size_t i = 0; i < sol.size(); ++i)
+    {
+        if (i) els << ' ';
+        els << sol[i];
+    }
+
+    r.sample_size = to_string(clara.sample_size());
+    r.time_limit_s = static_cast<double>(MAX_TIME_MILLIS) / 1000.0;
+    r.timed_out = false;
+    r.max_value = -sol.cost;
+    r.size = static_cast<int>(sol.size());
+    r.time_s = time_sec;
+    r.time_to_solution_s = static_cast<double>(clara.time_to_solution_ms) / 1000.0;
+    r.elements = els.str();
+    return r;
+}
+
+// Inner solver for the weighted coarsest level: WLS's descent reads the distance
+// matrix directly and would optimize the unweighted objective, so WLS and RW_BI fall
+// back to the standard variant.
+SolverKind weighted_inner(SolverKind kind)
+{
+    return (kind == SolverKind::WLS || kind == SolverKind::RW_BI) ? SolverKind::Standard : kind;
+}
+
+// The coarsest level gets ML_COARSE_SHARE of the time limit; refinement stops at the
+// limit.
+ExperimentResult run_multilevel_experiment(ExperimentConfig& config, string& instance_file,
+                                           int k, string& ttt_csv, double ilp_target,
+                                           const vector<vector<double>>& D)
+{
+    int n = static_cast<int>(D.size());
+
+    auto make_ml = [&](double target)
+    {
+        long budget_ms = max(1L, static_cast<long>(MAX_TIME_MILLIS * ML_COARSE_SHARE));
+        auto inner = [&config, budget_ms](vector<vector<double>>& Ds, const vector<double>& w, int kk)
+        {
+            return solve_subsample(weighted_inner(ML_INNER), config.alpha, config.p, Ds, kk,
+                                   budget_ms, w);
+        };
+
+        Multilevel_KMedoids::TargetCheck check = nullptr;
+        if (target > 0.0) check = [target](double c) { return reached_target_4dec(c, target); };
+
+        return Multilevel_KMedoids(D, k, ML_COARSE_SIZE, ML_CANDIDATES, ML_FINAL_PASSES, inner,
+                                   check, ML_LEVEL_PASSES, MAX_TIME_MILLIS, nullptr, ML_MATCH_L);
+    };
+
+    ExperimentResult r{};
+    r.config = config.name;
+    r.file = instance_file;
+    r.n = n;
+    r.k = k;
+    r.alpha = config.alpha;
+    r.construct_mode = "MULTILEVEL";
+    r.ls_mode = ls_mode_label(weighted_inner(ML_INNER));
+    r.iterations = MAX_TOTAL_ITERATIONS;
+    r.feasible = true;
+
+    if (ENABLE_TTT_MODE)
+    {
+        double target_avg = (ilp_target > 0.0) ? ilp_target : get_target_avg_for(instance_file, k);
+        save_ttt_header_if_needed(ttt_csv);
+
+        MAX_TIME_MILLIS = 30 * 1000;
+
+        for (int run = 0; run < TTT_RUNS; ++run)
+        {
+            AbstractGRASP<int>::set_seed(run);
+            auto ml = make_ml(target_avg);
+            ml.solve();
+            r.sample_size = to_string(ml.coarsest_size());
+            append_ttt_line(ttt_csv, instance_file, k, config.name, target_avg, run,
+                            ml.time_to_target_ms);
+        }
+        r.time_limit_s = static_cast<double>(MAX_TIME_MILLIS) / 1000.0;
+        return r;
+    }
+
+    auto ml = make_ml(ilp_target);
+    auto sol = ml.solve();
+    double time_sec = static_cast<double>(ml.execution_time_ms) / 1000.0;
+
+    cout << "    -> Total: " << fixed << setprecision(6) << sol.cost * n << " | Avg: " << sol.cost
+         << ", Levels: " << ml.levels() << " (coarsest " << ml.coarsest_size() << ")"
+         << ", Time: " << setprecision(3) << time_sec << "s\n";
+
+    ostringstream els;
+    for (size_t i = 0; i < sol.size(); ++i)
+    {
+        if (i) els << ' ';
+        els << sol[i];
+    }
+
+    r.sample_size = to_string(ml.coarsest_size());
+    r.time_limit_s = static_cast<double>(MAX_TIME_MILLIS) / 1000.0;
+    r.timed_out = false;
+    r.max_value = -sol.cost;
+    r.size = static_cast<int>(sol.size());
+    r.time_s = time_sec;
+    r.time_to_solution_s = static_cast<double>(ml.time_to_solution_ms) / 1000.0;
+    r.elements = els.str();
+    return r;
+}
+
 ExperimentResult run_experiment(ExperimentConfig& config, string& instance_file, int k,
                                 string& ttt_csv)
 {
     cout << "  Running: " << config.name << " | k=" << k << " | on " << instance_file << "\n";
 
     string instance_path = INSTANCES_DIR + "/" + instance_file;
-    auto D = load_distance_matrix(instance_path);
-    int n = static_cast<int>(D.size());
 
     double ilp_target = -1.0;
-    if (USE_ILP_CSV)
+    if (USE_ILP_CSV && METRIC == Metric::Euclidean)
     {
         double tavg = -1.0;
         if (try_get_ilp_optimum(instance_file, k, tavg)) ilp_target = tavg;
@@ -1286,6 +1875,57 @@ ExperimentResult run_experiment(ExperimentConfig& config, string& instance_file,
     {
         cout << "    [target] ILP avg = " << setprecision(12) << ilp_target << "\n";
     }
+    if (METRIC != Metric::Euclidean) cout << "    [metric] " << metric_name(METRIC) << "\n";
+
+    if (config.kind == SolverKind::CLARA)
+        return run_clara_experiment(config, instance_file, k, ttt_csv, ilp_target);
+
+    auto X = load_features(instance_path);
+    int n = static_cast<int>(X.size());
+    int dim = X.empty() ? 0 : static_cast<int>(X[0].size());
+
+    vector<vector<double>> D;
+    DistanceBackend backend;
+    bool compact = (USE_QUANTIZED_DISTANCES || USE_FLOAT32_DISTANCES) &&
+                   !reads_distance_matrix(config.kind);
+    if (use_feature_space(config.kind, n, dim))
+    {
+        backend.features = make_shared<const PointFeatures>(X, METRIC);
+        cout << "    [features] distances from " << dim << " coordinates, no distance matrix\n";
+    }
+    else if (compact)
+    {
+        backend.features = make_shared<const PointFeatures>(X, METRIC);
+        if (USE_QUANTIZED_DISTANCES)
+        {
+            backend.quant = make_shared<const Quantized16Distances>(*backend.features);
+            cout << "    [quantized] 16-bit distance matrix, max error "
+                 << scientific << setprecision(2) << backend.quant->max_error() << defaultfloat
+                 << ", moves re-checked exactly\n";
+        }
+        else
+        {
+            backend.dist32 = make_shared<const Float32Distances>(*backend.features);
+            cout << "    [float32] distance matrix in float32, costs verified in double\n";
+        }
+    }
+    else
+    {
+        D = pairwise_distances(X, METRIC);
+    }
+
+    if (config.kind == SolverKind::Multilevel)
+        return run_multilevel_experiment(config, instance_file, k, ttt_csv, ilp_target, D);
+
+    bool granular = (config.kind == SolverKind::GLS || config.kind == SolverKind::GLS_FI);
+    auto gls_mode = (config.kind == SolverKind::GLS_FI) ? GRASP_KMedoids_GLS::LSSearch::FirstImproving
+                                                        : GRASP_KMedoids_GLS::LSSearch::BestImproving;
+    shared_ptr<const NeighborIndex> nbr_index;
+    if (granular) nbr_index = make_shared<const NeighborIndex>(D, GRANULAR_L);
+
+    shared_ptr<const NeighborIndex> rank_lists;
+    if (USE_RANK_LISTS && k >= RANK_LISTS_MIN_K && !D.empty())
+        rank_lists = make_shared<const NeighborIndex>(D, n <= RANK_FULL_MAX_N ? n - 1 : RANK_TRUNCATED_L);
 
     if (ENABLE_TTT_MODE)
     {
@@ -1299,15 +1939,27 @@ ExperimentResult run_experiment(ExperimentConfig& config, string& instance_file,
 
         MAX_TIME_MILLIS = 30 * 1000;
 
+        // reactive: final alpha probabilities averaged over the runs
+        vector<double> reactive_probs;
+
         for (int run = 0; run < TTT_RUNS; ++run)
         {
-            if (config.kind == SolverKind::Standard)
+            if (config.kind == SolverKind::Standard || config.kind == SolverKind::Reactive)
             {
                 GRASP_KMedoids_WithStopping grasp(config.alpha, MAX_TOTAL_ITERATIONS, D, k,
                                                   MAX_TIME_MILLIS, target_avg, true);
+                if (config.kind == SolverKind::Reactive)
+                    grasp.setReactive(REACTIVE_ALPHAS, REACTIVE_BLOCK);
 
+                configure_grasp(grasp, rank_lists, backend);
                 grasp.set_seed(run);
                 auto sol = grasp.solve();
+                if (config.kind == SolverKind::Reactive)
+                {
+                    reactive_probs.resize(grasp.reactiveProbs.size(), 0.0);
+                    for (size_t i = 0; i < reactive_probs.size(); ++i)
+                        reactive_probs[i] += grasp.reactiveProbs[i] / TTT_RUNS;
+                }
                 append_ttt_line(ttt_csv, instance_file, k, config.name, target_avg, run,
                                 grasp.time_to_target_ms);
             }
@@ -1315,6 +1967,7 @@ ExperimentResult run_experiment(ExperimentConfig& config, string& instance_file,
             {
                 GRASP_KMedoids_FI_WithStopping grasp(config.alpha, MAX_TOTAL_ITERATIONS, D, k,
                                                      MAX_TIME_MILLIS, target_avg, true);
+                configure_grasp(grasp, rank_lists, backend);
                 grasp.set_seed(run);
                 auto sol = grasp.solve();
                 append_ttt_line(ttt_csv, instance_file, k, config.name, target_avg, run,
@@ -1324,6 +1977,7 @@ ExperimentResult run_experiment(ExperimentConfig& config, string& instance_file,
             {
                 GRASP_KMedoids_POP_WithStopping grasp(config.alpha, MAX_TOTAL_ITERATIONS, D, k,
                                                       MAX_TIME_MILLIS, target_avg, true);
+                configure_grasp(grasp, rank_lists, backend);
                 grasp.set_seed(run);
                 auto sol = grasp.solve();
                 append_ttt_line(ttt_csv, instance_file, k, config.name, target_avg, run,
@@ -1333,6 +1987,19 @@ ExperimentResult run_experiment(ExperimentConfig& config, string& instance_file,
             {
                 GRASP_KMedoids_RPG_WithStopping grasp(0.0, MAX_TOTAL_ITERATIONS, D, k, config.p,
                                                       MAX_TIME_MILLIS, target_avg, true);
+                if (config.p <= 0) grasp.setStochasticGreedy(config.epsilon);
+                configure_grasp(grasp, rank_lists, backend);
+                grasp.set_seed(run);
+                auto sol = grasp.solve();
+                append_ttt_line(ttt_csv, instance_file, k, config.name, target_avg, run,
+                                grasp.time_to_target_ms);
+            }
+            else if (granular)
+            {
+                GRASP_KMedoids_GLS_WithStopping grasp(config.alpha, MAX_TOTAL_ITERATIONS, D, k,
+                                                      gls_mode, nbr_index, MAX_TIME_MILLIS,
+                                                      target_avg, true);
+                configure_grasp(grasp, rank_lists, backend);
                 grasp.set_seed(run);
                 auto sol = grasp.solve();
                 append_ttt_line(ttt_csv, instance_file, k, config.name, target_avg, run,
@@ -1342,6 +2009,7 @@ ExperimentResult run_experiment(ExperimentConfig& config, string& instance_file,
             {
                 GRASP_KMedoids_WLS_WithStopping grasp(config.alpha, MAX_TOTAL_ITERATIONS, D, k,
                                                       MAX_TIME_MILLIS, target_avg, true);
+                configure_grasp(grasp, rank_lists, backend);
                 grasp.set_seed(run);
                 auto sol = grasp.solve();
                 append_ttt_line(ttt_csv, instance_file, k, config.name, target_avg, run,
@@ -1356,14 +2024,20 @@ ExperimentResult run_experiment(ExperimentConfig& config, string& instance_file,
         r.k = k;
         r.alpha = (config.kind == SolverKind::RPG) ? -1.0 : config.alpha;
 
-        r.construct_mode = (config.kind == SolverKind::RPG) ? "RPG"
+        r.construct_mode = (config.kind == SolverKind::RPG && config.p <= 0) ? "STOCHASTIC_GREEDY"
+            : (config.kind == SolverKind::RPG)              ? "RPG"
             : (config.kind == SolverKind::POP)              ? "STANDARD+POP"
             : (config.kind == SolverKind::WLS)              ? "WLS"
+            : (config.kind == SolverKind::Reactive)         ? "REACTIVE"
                                                             : "STANDARD";
+        r.construct_mode += construct_suffix(config.kind);
 
-        r.ls_mode = (config.kind == SolverKind::StandardFI) ? "FIRST_IMPROVING"
-            : (config.kind == SolverKind::RW_BI)            ? "FAST_INTERCHANGE_BI"
-                                                            : "BEST_IMPROVING";
+        r.ls_mode = ls_mode_label(config.kind);
+        if (config.kind == SolverKind::Reactive)
+        {
+            r.reactive_alphas = format_reactive_alphas(REACTIVE_ALPHAS, reactive_probs);
+            r.reactive_block = to_string(REACTIVE_BLOCK);
+        }
         r.iterations = MAX_TOTAL_ITERATIONS;
         r.time_limit_s = static_cast<double>(MAX_TIME_MILLIS) / 1000.0;
         r.timed_out = false;
@@ -1380,61 +2054,117 @@ ExperimentResult run_experiment(ExperimentConfig& config, string& instance_file,
     long exec_ms = 0;
     long time_to_solution_ms = -1;
     bool stopped_by_time = false;
+    double prune_rate = 0.0;
+    long memo_hits = 0, memo_lookups = 0;
+    long ls_passed = 0, ls_skipped = 0;
+    int rpg_sample = config.p;
+    vector<double> reactive_probs;
 
-    if (config.kind == SolverKind::Standard)
+    if (config.kind == SolverKind::Standard || config.kind == SolverKind::Reactive)
     {
         GRASP_KMedoids_WithStopping grasp(config.alpha, MAX_TOTAL_ITERATIONS, D, k, MAX_TIME_MILLIS,
                                           ilp_target, false);
+        if (config.kind == SolverKind::Reactive) grasp.setReactive(REACTIVE_ALPHAS, REACTIVE_BLOCK);
+        configure_grasp(grasp, rank_lists, backend);
         sol = grasp.solve();
+        reactive_probs = grasp.reactiveProbs;
         total_iterations = grasp.total_iterations;
         iterations_to_best = grasp.iterations_to_best;
         exec_ms = grasp.execution_time_ms;
         time_to_solution_ms = grasp.time_to_solution_ms;
         stopped_by_time = grasp.stopped_by_time;
+        prune_rate = grasp.evaluator().prune_hit_rate();
+        memo_hits = grasp.localOptimumHits();
+        memo_lookups = grasp.localOptimumLookups();
+        ls_passed = grasp.localSearchesPassed();
+        ls_skipped = grasp.localSearchesSkipped();
     }
     else if (config.kind == SolverKind::StandardFI)
     {
         GRASP_KMedoids_FI_WithStopping grasp(config.alpha, MAX_TOTAL_ITERATIONS, D, k,
                                              MAX_TIME_MILLIS, ilp_target, false);
+        configure_grasp(grasp, rank_lists, backend);
         sol = grasp.solve();
         total_iterations = grasp.total_iterations;
         iterations_to_best = grasp.iterations_to_best;
         exec_ms = grasp.execution_time_ms;
         time_to_solution_ms = grasp.time_to_solution_ms;
         stopped_by_time = grasp.stopped_by_time;
+        prune_rate = grasp.evaluator().prune_hit_rate();
+        memo_hits = grasp.localOptimumHits();
+        memo_lookups = grasp.localOptimumLookups();
+        ls_passed = grasp.localSearchesPassed();
+        ls_skipped = grasp.localSearchesSkipped();
     }
     else if (config.kind == SolverKind::POP)
     {
         GRASP_KMedoids_POP_WithStopping grasp(config.alpha, MAX_TOTAL_ITERATIONS, D, k,
                                               MAX_TIME_MILLIS, ilp_target, false);
+        configure_grasp(grasp, rank_lists, backend);
         sol = grasp.solve();
         total_iterations = grasp.total_iterations;
         iterations_to_best = grasp.iterations_to_best;
         exec_ms = grasp.execution_time_ms;
         time_to_solution_ms = grasp.time_to_solution_ms;
         stopped_by_time = grasp.stopped_by_time;
+        prune_rate = grasp.evaluator().prune_hit_rate();
+        memo_hits = grasp.localOptimumHits();
+        memo_lookups = grasp.localOptimumLookups();
+        ls_passed = grasp.localSearchesPassed();
+        ls_skipped = grasp.localSearchesSkipped();
     }
     else if (config.kind == SolverKind::RPG)
     {
         GRASP_KMedoids_RPG_WithStopping grasp(0.0, MAX_TOTAL_ITERATIONS, D, k, config.p,
                                               MAX_TIME_MILLIS, ilp_target, false);
+        if (config.p <= 0) grasp.setStochasticGreedy(config.epsilon);
+        configure_grasp(grasp, rank_lists, backend);
+        sol = grasp.solve();
+        rpg_sample = grasp.sampleSize();
+        total_iterations = grasp.total_iterations;
+        iterations_to_best = grasp.iterations_to_best;
+        exec_ms = grasp.execution_time_ms;
+        time_to_solution_ms = grasp.time_to_solution_ms;
+        stopped_by_time = grasp.stopped_by_time;
+        prune_rate = grasp.evaluator().prune_hit_rate();
+        memo_hits = grasp.localOptimumHits();
+        memo_lookups = grasp.localOptimumLookups();
+        ls_passed = grasp.localSearchesPassed();
+        ls_skipped = grasp.localSearchesSkipped();
+    }
+    else if (granular)
+    {
+        GRASP_KMedoids_GLS_WithStopping grasp(config.alpha, MAX_TOTAL_ITERATIONS, D, k, gls_mode,
+                                              nbr_index, MAX_TIME_MILLIS, ilp_target, false);
+        configure_grasp(grasp, rank_lists, backend);
         sol = grasp.solve();
         total_iterations = grasp.total_iterations;
         iterations_to_best = grasp.iterations_to_best;
         exec_ms = grasp.execution_time_ms;
         time_to_solution_ms = grasp.time_to_solution_ms;
         stopped_by_time = grasp.stopped_by_time;
+        prune_rate = grasp.evaluator().prune_hit_rate();
+        memo_hits = grasp.localOptimumHits();
+        memo_lookups = grasp.localOptimumLookups();
+        ls_passed = grasp.localSearchesPassed();
+        ls_skipped = grasp.localSearchesSkipped();
     }
     else
     {
         GRASP_KMedoids_WLS_WithStopping grasp(config.alpha, MAX_TOTAL_ITERATIONS, D, k,
                                               MAX_TIME_MILLIS);
+        configure_grasp(grasp, rank_lists, backend);
         sol = grasp.solve();
         total_iterations = grasp.total_iterations;
         iterations_to_best = grasp.iterations_to_best;
         exec_ms = grasp.execution_time_ms;
         time_to_solution_ms = grasp.time_to_solution_ms;
         stopped_by_time = grasp.stopped_by_time;
+        prune_rate = grasp.evaluator().prune_hit_rate();
+        memo_hits = grasp.localOptimumHits();
+        memo_lookups = grasp.localOptimumLookups();
+        ls_passed = grasp.localSearchesPassed();
+        ls_skipped = grasp.localSearchesSkipped();
     }
 
     double best_avg = sol.cost;
@@ -1443,6 +2173,12 @@ ExperimentResult run_experiment(ExperimentConfig& config, string& instance_file,
 
     cout << "    -> Total: " << fixed << setprecision(6) << best_total << " | Avg: " << best_avg
          << ", Iter: " << total_iterations << ", Time: " << setprecision(3) << time_sec << "s\n";
+    if (USE_TRIANGLE_PRUNING)
+        cout << "    [prune] exchange point visits skipped: " << setprecision(1)
+             << 100.0 * prune_rate << "%\n";
+    if (memo_lookups > 0)
+        cout << "    [ls-cache] local searches skipped: " << memo_hits << '/' << memo_lookups
+             << " (" << setprecision(1) << 100.0 * memo_hits / memo_lookups << "%)\n";
 
     ostringstream els;
     for (size_t i = 0; i < sol.size(); ++i)
@@ -1458,16 +2194,22 @@ ExperimentResult run_experiment(ExperimentConfig& config, string& instance_file,
     r.k = k;
     r.alpha = (config.kind == SolverKind::RPG) ? -1.0 : config.alpha;
 
-    r.construct_mode = (config.kind == SolverKind::RPG) ? "RPG"
+    r.construct_mode = (config.kind == SolverKind::RPG && config.p <= 0) ? "STOCHASTIC_GREEDY"
+        : (config.kind == SolverKind::RPG)              ? "RPG"
         : (config.kind == SolverKind::POP)              ? "STANDARD+POP"
+        : (config.kind == SolverKind::Reactive)         ? "REACTIVE"
                                                         : "STANDARD";
+    r.construct_mode += construct_suffix(config.kind);
 
-    r.ls_mode = (config.kind == SolverKind::StandardFI) ? "FIRST_IMPROVING"
-        : (config.kind == SolverKind::RW_BI)            ? "FAST_INTERCHANGE_BI"
-                                                        : "BEST_IMPROVING";
+    r.ls_mode = ls_mode_label(config.kind);
     r.reactive_alphas = "";
     r.reactive_block = "";
-    r.sample_size = (config.kind == SolverKind::RPG) ? to_string(config.p) : "";
+    if (config.kind == SolverKind::Reactive)
+    {
+        r.reactive_alphas = format_reactive_alphas(REACTIVE_ALPHAS, reactive_probs);
+        r.reactive_block = to_string(REACTIVE_BLOCK);
+    }
+    r.sample_size = (config.kind == SolverKind::RPG) ? to_string(rpg_sample) : "";
     r.iterations = MAX_TOTAL_ITERATIONS;
     r.time_limit_s = static_cast<double>(MAX_TIME_MILLIS) / 1000.0;
     r.timed_out = stopped_by_time;
@@ -1476,6 +2218,8 @@ ExperimentResult run_experiment(ExperimentConfig& config, string& instance_file,
     r.feasible = true;
     r.time_s = time_sec;
     r.time_to_solution_s = static_cast<double>(time_to_solution_ms) / 1000.0;
+    r.ls_passed = ls_passed;
+    r.ls_skipped = ls_skipped;
     r.elements = els.str();
 
     return r;
@@ -1525,7 +2269,7 @@ void save_results_to_csv(vector<ExperimentResult>& results, string& output_file)
 
     f << "config,file,n,k,alpha,construct_mode,ls_mode,reactive_alphas,reactive_block,"
          "sample_size,iterations,time_limit_s,timed_out,max_value,size,feasible,time_s,time_to_"
-         "solution_s,elements\n";
+         "solution_s,ls_passed,ls_skipped,elements\n";
 
     f.setf(ios::fixed);
     for (auto& r : results)
@@ -1536,7 +2280,8 @@ void save_results_to_csv(vector<ExperimentResult>& results, string& output_file)
           << setprecision(0) << r.time_limit_s << ',' << (r.timed_out ? "true" : "false") << ','
           << setprecision(6) << r.max_value << ',' << r.size << ','
           << (r.feasible ? "true" : "false") << ',' << setprecision(3) << r.time_s << ','
-          << r.time_to_solution_s << ",\"" << r.elements << "\"\n";
+          << r.time_to_solution_s << ',' << r.ls_passed << ',' << r.ls_skipped << ",\""
+          << r.elements << "\"\n";
     }
     cout << "\nResults saved to: " << output_file << "\n";
 }
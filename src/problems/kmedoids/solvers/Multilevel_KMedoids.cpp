@@ -0,0 +1,264 @@
+#include "Multilevel_KMedoids.h"
+
+#include <chrono>
+#include <limits>
+#include <numeric>
+#include <random>
+
+#include "../../../metaheuristics/grasp/AbstractGRASP.h"
+
+Multilevel_KMedoids::Multilevel_KMedoids(const vector<vector<double>>& D, int k, int coarse_size,
+                                         int candidates, int final_passes, SubSolver solver,
+                                         TargetCheck reached_target, int level_passes,
+                                         long time_limit_ms, shared_ptr<const NeighborIndex> nbrs,
+                                         int match_l)
+    : D_(D),
+      n_(static_cast<int>(D.size())),
+      k_(k),
+      coarse_size_(max(k, coarse_size > 0 ? coarse_size : default_coarse_size(k))),
+      candidates_(max(1, candidates)),
+      final_passes_(max(0, final_passes)),
+      level_passes_(max(0, level_passes)),
+      solver_(move(solver)),
+      reached_target_(move(reached_target)),
+      time_limit_ms_(time_limit_ms),
+      nbrs_(move(nbrs)),
+      match_l_(max(1, match_l))
+{
+}
+
+// Greedy matching in random order: each unmatched point is merged with its nearest
+// unmatched graph neighbor, the heavier of the two becoming the representative
+// (points with no unmatched neighbor stay alone). Stops at coarse_size_ points, when
+// halving again would leave fewer than k points, or when a level shrinks by less
+// than a tenth (the graph has run out of matches).
+void Multilevel_KMedoids::coarsen()
+{
+    auto& rng = AbstractGRASP<int>::rng;
+    if (!nbrs_) nbrs_ = make_shared<const NeighborIndex>(D_, match_l_);
+
+    levels_.clear();
+    Level base;
+    base.points.resize(n_);
+    iota(base.points.begin(), base.points.end(), 0);
+    base.weights.assign(n_, 1.0);
+    base.adj.resize(n_);
+    for (int i = 0; i < n_; ++i) base.adj[i] = nbrs_->neighbors(i);
+    levels_.push_back(move(base));
+
+    while (true)
+    {
+        const Level& fine = levels_.back();
+        const int m = static_cast<int>(fine.points.size());
+        if (m <= coarse_size_ || m / 2 < k_) break;
+
+        vector<int> order(m);
+        iota(order.begin(), order.end(), 0);
+        shuffle(order.begin(), order.end(), rng);
+
+        vector<int> coarse_of(m, -1);
+        Level coarse;
+        coarse.points.reserve(m / 2 + 1);
+        coarse.weights.reserve(m / 2 + 1);
+
+        for (int a : order)
+        {
+            if (coarse_of[a] >= 0) continue;
+            const int c = static_cast<int>(coarse.points.size());
+            coarse_of[a] = c;
+
+            int b = -1;
+            for (int j : fine.adj[a])
+            {
+                if (coarse_of[j] < 0)
+                {
+                    b = j;
+                    break;
+                }
+            }
+
+            int rep = a;
+            double w = fine.weights[a];
+            if (b >= 0)
+            {
+                coarse_of[b] = c;
+                if (fine.weights[b] > fine.weights[a]) rep = b;
+                w += fine.weights[b];
+            }
+            coarse.points.push_back(fine.points[rep]);
+            coarse.weights.push_back(w);
+        }
+
+        const int mc = static_cast<int>(coarse.points.size());
+        if (10L * mc > 9L * m) break;
+
+        // contracted graph: neighbors of the members, mapped to their representatives
+        coarse.adj.assign(mc, {});
+        for (int f = 0; f < m; ++f)
+        {
+            const int c = coarse_of[f];
+            for (int j : fine.adj[f])
+                if (coarse_of[j] != c) coarse.adj[c].push_back(coarse_of[j]);
+        }
+        for (int c = 0; c < mc; ++c)
+        {
+            auto& list = coarse.adj[c];
+            const auto& row = D_[coarse.points[c]];
+            auto by_dist = [&](int a, int b)
+            {
+                double da = row[coarse.points[a]], db = row[coarse.points[b]];
+                return da < db || (da == db && a < b);
+            };
+            sort(list.begin(), list.end(), by_dist);
+            list.erase(unique(list.begin(), list.end()), list.end());
+            if (static_cast<int>(list.size()) > match_l_) list.resize(match_l_);
+        }
+        levels_.push_back(move(coarse));
+    }
+}
+
+// Best-improvement swap search on one level (weighted objective over its points).
+// Each medoid may only be swapped with its `candidates` nearest non-medoid points of
+// the level; candidates <= 0 means the full neighborhood. max_passes = 0 (or being
+// out of time) only evaluates. Returns the weighted average distance to the nearest medoid.
+double Multilevel_KMedoids::refine(const Level& lv, vector<int>& medoids, int candidates,
+                                   int max_passes, const function<bool()>& out_of_time) const
+{
+    const double inf = numeric_limits<double>::infinity();
+    const int m = static_cast<int>(lv.points.size());
+    const int k = static_cast<int>(medoids.size());
+    const double total_w = accumulate(lv.weights.begin(), lv.weights.end(), 0.0);
+
+    vector<char> is_medoid(n_, 0);
+    for (int q : medoids) is_medoid[q] = 1;
+
+    vector<int> near1(m);
+    vector<double> dist1(m), dist2(m);
+    auto assign = [&]()
+    {
+        double total = 0.0;
+        for (int i = 0; i < m; ++i)
+        {
+            const auto& row = D_[lv.points[i]];
+            int s1 = -1;
+            double d1 = inf, d2 = inf;
+            for (int s = 0; s < k; ++s)
+            {
+                double d = row[medoids[s]];
+                if (d < d1)
+                {
+                    d2 = d1;
+                    d1 = d;
+                    s1 = s;
+                }
+                else if (d < d2)
+                {
+                    d2 = d;
+                }
+            }
+            near1[i] = s1;
+            dist1[i] = d1;
+            dist2[i] = d2;
+            total += lv.weights[i] * d1;
+        }
+        return total / total_w;
+    };
+
+    vector<int> pool;
+    auto collect_candidates = [&](int q)
+    {
+        pool.clear();
+        for (int j = 0; j < m; ++j)
+            if (!is_medoid[lv.points[j]]) pool.push_back(j);
+
+        if (candidates > 0 && static_cast<int>(pool.size()) > candidates)
+        {
+            const auto& row = D_[q];
+            nth_element(pool.begin(), pool.begin() + candidates, pool.end(),
+                        [&](int a, int b) { return row[lv.points[a]] < row[lv.points[b]]; });
+            pool.resize(candidates);
+        }
+    };
+
+    double cost = assign();
+    for (int pass = 0; pass < max_passes && !out_of_time(); ++pass)
+    {
+        double best_delta = -1e-12;
+        int best_slot = -1, best_in = -1;
+
+        for (int s = 0; s < k; ++s)
+        {
+            collect_candidates(medoids[s]);
+            for (int j : pool)
+            {
+                const auto& row = D_[lv.points[j]];
+                double delta = 0.0;
+                for (int i = 0; i < m; ++i)
+                {
+                    double keep = (near1[i] == s) ? dist2[i] : dist1[i];
+                    delta += lv.weights[i] * (min(keep, row[lv.points[i]]) - dist1[i]);
+                }
+                if (delta < best_delta)
+                {
+                    best_delta = delta;
+                    best_slot = s;
+                    best_in = j;
+                }
+            }
+        }
+        if (best_slot < 0) break;
+
+        is_medoid[medoids[best_slot]] = 0;
+        medoids[best_slot] = lv.points[best_in];
+        is_medoid[medoids[best_slot]] = 1;
+        cost = assign();
+    }
+    return cost;
+}
+
+Solution<int> Multilevel_KMedoids::solve()
+{
+    auto t0 = chrono::steady_clock::now();
+    auto elapsed_ms = [&t0]()
+    {
+        return static_cast<long>(
+            chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - t0).count());
+    };
+    auto finish = [&](const vector<int>& medoids, double cost)
+    {
+        Solution<int> sol(medoids.begin(), medoids.end());
+        sol.cost = cost;
+        execution_time_ms = elapsed_ms();
+        time_to_solution_ms = execution_time_ms;
+        if (reached_target_ && reached_target_(cost)) time_to_target_ms = execution_time_ms;
+        return sol;
+    };
+
+    coarsen();
+
+    const Level& top = levels_.back();
+    const int m = static_cast<int>(top.points.size());
+    vector<vector<double>> Ds(m, vector<double>(m, 0.0));
+    for (int a = 0; a < m; ++a)
+    {
+        const auto& row = D_[top.points[a]];
+        for (int b = 0; b < m; ++b) Ds[a][b] = row[top.points[b]];
+    }
+
+    Solution<int> local = solver_(Ds, top.weights, k_);
+    vector<int> medoids;
+    medoids.reserve(local.size());
+    for (int idx : local) medoids.push_back(top.points[idx]);
+
+    auto out_of_time = [&]() { return time_limit_ms_ > 0 && elapsed_ms() >= time_limit_ms_; };
+
+    double cost = 0.0;
+    for (int l = levels() - 1; l >= 0; --l)
+        cost = refine(levels_[l], medoids, candidates_, level_passes_, out_of_time);
+
+    // the restricted search on level 0 may already be enough
+    if (reached_target_ && reached_target_(cost)) return finish(medoids, cost);
+
+    cost = refine(levels_[0], medoids, 0, final_passes_, out_of_time);
+    return finish(medoids, cost);
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "../../../solutions/Solution.h"
+#include "../NeighborIndex.h"
+
+using namespace std;
+
+// Multilevel k-medoids: the point set is coarsened by repeatedly merging every point
+// with its nearest unmatched neighbor into a weighted representative, the coarsest
+// level is solved with a (weighted) k-medoids solver, and the medoids are projected
+// back level by level. Each finer level runs a swap local search restricted to the
+// nearest points of every medoid; level 0 ends with a few passes of the full swap
+// neighborhood.
+//
+// Matching only looks at a sparse neighbor graph: level 0 uses the NeighborIndex
+// lists, and a coarse point's neighbors are the representatives of its members'
+// neighbors (the match_l nearest kept), so a level costs O(m match_l log match_l)
+// instead of O(m^2). Refinement does at most level_passes moves per level and none
+// after the time limit (the final costs are still exact).
+class Multilevel_KMedoids
+{
+   public:
+    // Solves weighted k-medoids on the coarsest level's distance matrix; returns
+    // indices into it.
+    using SubSolver =
+        function<Solution<int>(vector<vector<double>>& Ds, const vector<double>& w, int k)>;
+
+    // Optional early stop once the full-resolution cost satisfies it.
+    using TargetCheck = function<bool(double)>;
+
+    // nbrs: neighbor lists of D (built with match_l entries when null). time_limit_ms
+    // bounds the whole solve (<= 0: none); the sub-solver gets its own budget.
+    Multilevel_KMedoids(const vector<vector<double>>& D, int k, int coarse_size, int candidates,
+                        int final_passes, SubSolver solver, TargetCheck reached_target = nullptr,
+                        int level_passes = 10, long time_limit_ms = 0,
+                        shared_ptr<const NeighborIndex> nbrs = nullptr, int match_l = 10);
+
+    Solution<int> solve();
+
+    static int default_coarse_size(int k) { return max(100, 10 * k); }
+
+    int levels() const { return static_cast<int>(levels_.size()); }
+    int coarsest_size() const
+    {
+        return levels_.empty() ? 0 : static_cast<int>(levels_.back().points.size());
+    }
+
+    long execution_time_ms{0};
+    long time_to_solution_ms{-1};
+    long time_to_target_ms{-1};
+
+   private:
+    // points are original indices (every representative is one of its members, so a
+    // level's points are a subset of the finer level's); weights count the members;
+    // adj[a] lists level indices of a's neighbors by increasing distance
+    struct Level
+    {
+        vector<int> points;
+        vector<double> weights;
+        vector<vector<int>> adj;
+    };
+
+    const vector<vector<double>>& D_;
+    int n_, k_, coarse_size_, candidates_, final_passes_, level_passes_;
+    SubSolver solver_;
+    TargetCheck reached_target_;
+    long time_limit_ms_;
+    shared_ptr<const NeighborIndex> nbrs_;
+    int match_l_;
+    vector<Level> levels_;
+
+    void coarsen();
+    double refine(const Level& lv, vector<int>& medoids, int candidates, int max_passes,
+                  const function<bool()>& out_of_time) const;
+};
@@ -15,7 +15,7 @@ class Solution : public vector<T>
     double cost;
 
     Solution() : Base(), cost(numeric_limits<double>::infinity()) {}
-    Solution(const Solution& other) : Base(other), cost(other.cost) {}
+    Solution(const Solution& other) = default;
 
     template <typename It>
     Solution(It first, It last) : Base(first, last), cost(numeric_limits<double>::infinity())